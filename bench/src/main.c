@@ -0,0 +1,468 @@
+/* Headless benchmark for the flecs.game module.
+ *
+ * Builds a scripted scenario and runs the systems of the world one by one, so
+ * that the time spent in each system can be measured. Results are written to
+ * stdout as one JSON object per line.
+ *
+ * Systems run with ecs_run instead of ecs_progress. Each frame is wrapped in
+ * ecs_frame_begin/ecs_frame_end, so that the frame counter, delta_time and
+ * world time advance like they do in ecs_progress. Each system runs in its
+ * own deferred block, so the time of a system includes merging the commands
+ * it enqueued. This differs from the pipeline, which merges at sync points. The
+ * ns_per_entity of a system is its time divided by the number of entities its
+ * query matched.
+ *
+ * Usage: bench [options]
+ *   --entities N      Number of moving entities (default 100000)
+ *   --speed S         Speed of moving entities (default 10)
+ *   --extent E        Entities are spawned in [-E, E] (default 10000)
+ *   --grid X Y Z      Create grid with X * Y * Z tiles (default none)
+ *   --cameras N       Number of camera controllers (default 1)
+ *   --lights N        Number of moving local lights (default 0)
+ *   --light-range R   Range of local lights (default 50)
+ *   --frames N        Number of measured frames (default 100)
+ *   --warmup N        Number of frames before measuring (default 10)
+ *   --camera-path F   Play back recorded camera path on the first camera
+ *   --seed N          Seed for random number generator (default 1)
+ *   --observers N     Number of moving entities with an interest area
+ *   --observer-radius R  Radius of interest areas (default 500)
+ *   --core            Only import the core module (no cameras or lights)
+ */
+
+#include <flecs_game.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#define BENCH_DELTA_TIME (1.0f / 60.0f)
+#define BENCH_SYSTEMS_MAX (256)
+
+typedef struct {
+    int32_t entities;
+    float speed;
+    float extent;
+    int32_t grid[3];
+    int32_t cameras;
+    int32_t lights;
+    float light_range;
+    int32_t frames;
+    int32_t warmup;
+    const char *camera_path;
+    unsigned int seed;
+    int32_t observers;
+    float observer_radius;
+    bool core;
+} bench_config_t;
+
+typedef struct {
+    int64_t enter;
+    int64_t leave;
+    int64_t update;
+    double time;
+} bench_interest_t;
+
+typedef struct {
+    ecs_entity_t system;
+    double time;
+    int64_t matched;       /* Sum of matched entities over measured frames */
+} bench_system_t;
+
+static
+float bench_randf(float min, float max) {
+    return min + (max - min) * (float)rand() / (float)RAND_MAX;
+}
+
+static
+int bench_parse_args(bench_config_t *cfg, int argc, char *argv[]) {
+    for (int i = 1; i < argc; i ++) {
+        const char *arg = argv[i];
+        int left = argc - i - 1;
+
+        if (!strcmp(arg, "--entities") && left >= 1) {
+            cfg->entities = atoi(argv[++ i]);
+        } else if (!strcmp(arg, "--speed") && left >= 1) {
+            cfg->speed = atof(argv[++ i]);
+        } else if (!strcmp(arg, "--extent") && left >= 1) {
+            cfg->extent = atof(argv[++ i]);
+        } else if (!strcmp(arg, "--grid") && left >= 3) {
+            cfg->grid[0] = atoi(argv[++ i]);
+            cfg->grid[1] = atoi(argv[++ i]);
+            cfg->grid[2] = atoi(argv[++ i]);
+        } else if (!strcmp(arg, "--cameras") && left >= 1) {
+            cfg->cameras = atoi(argv[++ i]);
+        } else if (!strcmp(arg, "--lights") && left >= 1) {
+            cfg->lights = atoi(argv[++ i]);
+        } else if (!strcmp(arg, "--light-range") && left >= 1) {
+            cfg->light_range = atof(argv[++ i]);
+        } else if (!strcmp(arg, "--frames") && left >= 1) {
+            cfg->frames = atoi(argv[++ i]);
+        } else if (!strcmp(arg, "--warmup") && left >= 1) {
+            cfg->warmup = atoi(argv[++ i]);
+        } else if (!strcmp(arg, "--camera-path") && left >= 1) {
+            cfg->camera_path = argv[++ i];
+        } else if (!strcmp(arg, "--seed") && left >= 1) {
+            cfg->seed = (unsigned int)atoi(argv[++ i]);
+        } else if (!strcmp(arg, "--observers") && left >= 1) {
+            cfg->observers = atoi(argv[++ i]);
+        } else if (!strcmp(arg, "--observer-radius") && left >= 1) {
+            cfg->observer_radius = atof(argv[++ i]);
+        } else if (!strcmp(arg, "--core")) {
+            cfg->core = true;
+        } else {
+            fprintf(stderr, "bench: invalid argument '%s'\n", arg);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static
+long bench_peak_memory_kb(void) {
+#ifndef _WIN32
+    struct rusage usage;
+    if (!getrusage(RUSAGE_SELF, &usage)) {
+        return usage.ru_maxrss;
+    }
+#endif
+    return -1;
+}
+
+static
+int64_t bench_structural_changes(const ecs_world_t *world) {
+    const ecs_world_info_t *info = ecs_get_world_info(world);
+    return info->cmd.add_count + info->cmd.remove_count +
+        info->cmd.delete_count + info->cmd.clear_count;
+}
+
+static
+int bench_compare_system(const void *ptr1, const void *ptr2) {
+    const bench_system_t *s1 = ptr1, *s2 = ptr2;
+    return (s1->system > s2->system) - (s1->system < s2->system);
+}
+
+/* Collect systems in pipeline order. Systems within a phase run in the order
+ * in which they were created, which is the order of their entity ids. */
+static
+int32_t bench_collect_systems(
+    ecs_world_t *world,
+    bench_system_t *systems)
+{
+    ecs_entity_t phases[] = {
+        EcsPreFrame, EcsOnLoad, EcsPostLoad, EcsPreUpdate, EcsOnUpdate,
+        EcsOnValidate, EcsPostUpdate, EcsPreStore, EcsOnStore, EcsPostFrame
+    };
+
+    int32_t count = 0;
+    for (size_t p = 0; p < sizeof(phases) / sizeof(phases[0]); p ++) {
+        int32_t phase_start = count;
+        ecs_filter_t *f = ecs_filter(world, {
+            .terms = {
+                { .id = EcsSystem },
+                { .id = ecs_dependson(phases[p]) },
+                { .id = EcsDisabled, .oper = EcsNot }
+            }
+        });
+
+        ecs_iter_t it = ecs_filter_iter(world, f);
+        while (ecs_filter_next(&it)) {
+            for (int i = 0; i < it.count; i ++) {
+                if (count == BENCH_SYSTEMS_MAX) {
+                    break;
+                }
+                systems[count ++] = (bench_system_t){
+                    .system = it.entities[i]
+                };
+            }
+        }
+
+        ecs_filter_fini(f);
+        qsort(&systems[phase_start], count - phase_start,
+            sizeof(bench_system_t), bench_compare_system);
+    }
+
+    return count;
+}
+
+/* Returns the first camera, if any */
+static
+ecs_entity_t bench_populate(
+    ecs_world_t *world,
+    const bench_config_t *cfg)
+{
+    ecs_singleton_set(world, EcsTimeOfDay, { .t = 0, .speed = 0.01 });
+
+    for (int32_t i = 0; i < cfg->entities; i ++) {
+        ecs_entity_t e = ecs_new_id(world);
+        float angle = bench_randf(0, 2 * GLM_PI);
+        ecs_set(world, e, EcsPosition3, {
+            bench_randf(-cfg->extent, cfg->extent), 0,
+            bench_randf(-cfg->extent, cfg->extent)
+        });
+        ecs_set(world, e, EcsVelocity3, {
+            cos(angle) * cfg->speed, 0, sin(angle) * cfg->speed
+        });
+        if (i < cfg->observers) {
+            ecs_set(world, e, EcsInterestArea, { cfg->observer_radius });
+        }
+    }
+
+    if (cfg->core) {
+        return 0;
+    }
+
+    ecs_add(world, ecs_id(EcsInput), EcsInput);
+
+    ecs_entity_t camera = 0;
+    for (int32_t i = 0; i < cfg->cameras; i ++) {
+        ecs_entity_t e = ecs_new_w_id(world, EcsCameraController);
+        ecs_set(world, e, EcsCamera, {
+            .fov = 0.6, .up = {0, 1, 0}, .near_ = 0.1, .far_ = 1000
+        });
+        if (!camera) {
+            camera = e;
+        }
+    }
+
+    if (cfg->lights) {
+        ecs_entity_t sun = ecs_new_w_id(world, EcsSun);
+        ecs_set(world, sun, EcsShadowCascades, {
+            .camera = camera, .count = 4, .lambda = 0.5, .height_max = 10,
+            .position_threshold = 1, .angle_threshold = 0.01
+        });
+    }
+
+    for (int32_t i = 0; i < cfg->lights; i ++) {
+        ecs_entity_t e = ecs_new_id(world);
+        float angle = bench_randf(0, 2 * GLM_PI);
+        ecs_set(world, e, EcsPosition3, {
+            bench_randf(-cfg->extent, cfg->extent), 5,
+            bench_randf(-cfg->extent, cfg->extent)
+        });
+        ecs_set(world, e, EcsVelocity3, {
+            cos(angle) * cfg->speed, 0, sin(angle) * cfg->speed
+        });
+        ecs_set(world, e, EcsLocalLight, { .range = cfg->light_range });
+    }
+
+    return camera;
+}
+
+static
+void bench_print_config(
+    const bench_config_t *cfg)
+{
+    printf("{\"type\":\"config\",\"entities\":%d,\"speed\":%f,"
+        "\"extent\":%f,\"grid\":[%d,%d,%d],\"cameras\":%d,\"lights\":%d,"
+        "\"light_range\":%f,\"frames\":%d,\"warmup\":%d,\"seed\":%u,"
+        "\"core\":%s}\n",
+        cfg->entities, (double)cfg->speed, (double)cfg->extent,
+        cfg->grid[0], cfg->grid[1], cfg->grid[2], cfg->cameras, cfg->lights,
+        (double)cfg->light_range, cfg->frames, cfg->warmup, cfg->seed,
+        cfg->core ? "true" : "false");
+}
+
+static
+void bench_grid(
+    ecs_world_t *world,
+    const bench_config_t *cfg)
+{
+    int32_t tiles = cfg->grid[0] * cfg->grid[1] * cfg->grid[2];
+    if (!tiles) {
+        return;
+    }
+
+    ecs_entity_t prefab = ecs_new_prefab(world, "BenchTile");
+    ecs_entity_t grid = ecs_new_id(world);
+
+    ecs_time_t t = {0};
+    ecs_time_measure(&t);
+    ecs_set(world, grid, EcsGrid, {
+        .x = { .count = cfg->grid[0], .spacing = 2 },
+        .y = { .count = cfg->grid[1], .spacing = 2 },
+        .z = { .count = cfg->grid[2], .spacing = 2 },
+        .prefab = prefab
+    });
+    double elapsed = ecs_time_measure(&t);
+
+    printf("{\"type\":\"grid\",\"tiles\":%d,\"time_ms\":%f,"
+        "\"ns_per_tile\":%f}\n", tiles, elapsed * 1000.0,
+        elapsed * 1000000000.0 / tiles);
+}
+
+/* Local loopback consumer of the interest sets. Copies the positions of the
+ * entered and updated entities of each observer into a buffer, like a
+ * replication layer would before sending them to a client. */
+static
+void bench_interest_consume(
+    ecs_world_t *world,
+    bench_interest_t *stats,
+    ecs_vec_t *buffer)
+{
+    ecs_time_t t = {0};
+    ecs_time_measure(&t);
+
+    ecs_iter_t it = ecs_term_iter(world, &(ecs_term_t){
+        .id = ecs_id(EcsInterestArea)
+    });
+
+    while (ecs_term_next(&it)) {
+        for (int i = 0; i < it.count; i ++) {
+            int32_t enter_count, leave_count, update_count;
+            const ecs_entity_t *enter = ecs_interest_enter(
+                world, it.entities[i], &enter_count);
+            const ecs_entity_t *update = ecs_interest_update(
+                world, it.entities[i], &update_count);
+            ecs_interest_leave(world, it.entities[i], &leave_count);
+
+            ecs_vec_clear(buffer);
+            for (int32_t e = 0; e < enter_count; e ++) {
+                const EcsPosition3 *p = ecs_get(world, enter[e], EcsPosition3);
+                if (p) {
+                    ecs_vec_append_t(NULL, buffer, EcsPosition3)[0] = *p;
+                }
+            }
+            for (int32_t e = 0; e < update_count; e ++) {
+                const EcsPosition3 *p = ecs_get(world, update[e], EcsPosition3);
+                if (p) {
+                    ecs_vec_append_t(NULL, buffer, EcsPosition3)[0] = *p;
+                }
+            }
+
+            stats->enter += enter_count;
+            stats->leave += leave_count;
+            stats->update += update_count;
+        }
+    }
+
+    stats->time += ecs_time_measure(&t);
+}
+
+int main(int argc, char *argv[]) {
+    bench_config_t cfg = {
+        .entities = 100000,
+        .speed = 10,
+        .extent = 10000,
+        .cameras = 1,
+        .light_range = 50,
+        .frames = 100,
+        .warmup = 10,
+        .seed = 1,
+        .observer_radius = 500
+    };
+
+    if (bench_parse_args(&cfg, argc, argv)) {
+        return -1;
+    }
+
+    srand(cfg.seed);
+
+    ecs_world_t *world = ecs_init();
+    if (cfg.core) {
+        ECS_IMPORT(world, FlecsGameCore);
+        cfg.cameras = 0;
+        cfg.lights = 0;
+    } else {
+        ECS_IMPORT(world, FlecsGame);
+    }
+
+    bench_print_config(&cfg);
+    bench_grid(world, &cfg);
+    ecs_entity_t camera = bench_populate(world, &cfg);
+
+    if (cfg.camera_path && camera) {
+        if (ecs_camera_path_load(world, camera, cfg.camera_path)) {
+            ecs_fini(world);
+            return -1;
+        }
+        ecs_set(world, camera, EcsCameraPathPlay, {
+            .timestep = BENCH_DELTA_TIME, .loop = true
+        });
+    }
+
+    bench_system_t systems[BENCH_SYSTEMS_MAX];
+    int32_t system_count = bench_collect_systems(world, systems);
+    int64_t structural_changes = 0;
+    int64_t entity_count = cfg.entities + cfg.lights + cfg.cameras;
+    double frame_time = 0;
+    bench_interest_t interest = {0};
+    ecs_vec_t interest_buffer = {0};
+
+    for (int32_t f = 0; f < cfg.warmup + cfg.frames; f ++) {
+        bool measure = f >= cfg.warmup;
+        int64_t changes = bench_structural_changes(world);
+
+        ecs_time_t t_frame = {0};
+        ecs_time_measure(&t_frame);
+        ecs_ftime_t delta_time = ecs_frame_begin(world, BENCH_DELTA_TIME);
+
+        for (int32_t s = 0; s < system_count; s ++) {
+            ecs_query_t *q = ecs_system_get_query(world, systems[s].system);
+            if (measure && q) {
+                systems[s].matched += ecs_query_entity_count(q);
+            }
+
+            ecs_time_t t = {0};
+            ecs_time_measure(&t);
+            ecs_defer_begin(world);
+            ecs_run(world, systems[s].system, delta_time, NULL);
+            ecs_defer_end(world);
+            if (measure) {
+                systems[s].time += ecs_time_measure(&t);
+            }
+        }
+
+        ecs_frame_end(world);
+
+        if (measure) {
+            frame_time += ecs_time_measure(&t_frame);
+            structural_changes += bench_structural_changes(world) - changes;
+            if (cfg.observers) {
+                bench_interest_consume(world, &interest, &interest_buffer);
+            }
+        }
+    }
+
+    ecs_vec_fini_t(NULL, &interest_buffer, EcsPosition3);
+
+    for (int32_t s = 0; s < system_count; s ++) {
+        char *path = ecs_get_fullpath(world, systems[s].system);
+        double ns = systems[s].time * 1000000000.0 / cfg.frames;
+        printf("{\"type\":\"system\",\"name\":\"%s\",\"ns_per_frame\":%f,"
+            "\"matched_per_frame\":%f,", path, ns,
+            (double)systems[s].matched / cfg.frames);
+        if (systems[s].matched) {
+            printf("\"ns_per_entity\":%f}\n", 
+                systems[s].time * 1000000000.0 / systems[s].matched);
+        } else {
+            printf("\"ns_per_entity\":null}\n");
+        }
+        ecs_os_free(path);
+    }
+
+    if (cfg.observers) {
+        printf("{\"type\":\"interest\",\"observers\":%d,\"radius\":%f,"
+            "\"enter_per_frame\":%f,\"leave_per_frame\":%f,"
+            "\"update_per_frame\":%f,\"consume_ns_per_frame\":%f}\n",
+            cfg.observers, (double)cfg.observer_radius,
+            (double)interest.enter / cfg.frames,
+            (double)interest.leave / cfg.frames,
+            (double)interest.update / cfg.frames,
+            interest.time * 1000000000.0 / cfg.frames);
+    }
+
+    printf("{\"type\":\"summary\",\"frames\":%d,\"entities\":%lld,"
+        "\"ms_per_frame\":%f,\"structural_changes_per_frame\":%f,"
+        "\"peak_memory_kb\":%ld,"
+        "\"system_timing\":\"ecs_run, merged after each system\"}\n",
+        cfg.frames, (long long)entity_count,
+        frame_time * 1000.0 / cfg.frames,
+        (double)structural_changes / cfg.frames,
+        bench_peak_memory_kb());
+
+    ecs_fini(world);
+    return 0;
+}
@@ -0,0 +1,492 @@
+#ifndef FLECS_GAME_CORE_H
+#define FLECS_GAME_CORE_H
+
+/* This generated file contains includes for project dependencies */
+#include "flecs-game-core/bake_config.h"
+
+// Reflection system boilerplate
+#undef ECS_META_IMPL
+#ifndef FLECS_GAME_CORE_IMPL
+#define ECS_META_IMPL EXTERN // Ensure meta symbols are only defined once
+#endif
+
+// Number of bits to shift from x/y coordinate before creating the spatial hash.
+// Larger numbers create larger cells.
+#define FLECS_GAME_WORLD_CELL_SHIFT (8)
+
+// Convenience macro to get size of world cell
+#define FLECS_GAME_WORLD_CELL_SIZE (1 << FLECS_GAME_WORLD_CELL_SHIFT)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of samples in the time of day lookup table
+#define FLECS_GAME_TIME_OF_DAY_LUT_SIZE (256)
+
+// Maximum number of keys in a time of day curve
+#define FLECS_GAME_TIME_OF_DAY_KEYS_MAX (8)
+
+FLECS_GAME_CORE_API
+ECS_STRUCT(EcsTimeOfDay, {
+    float t;
+    float speed;
+});
+
+FLECS_GAME_CORE_API
+ECS_STRUCT(ecs_time_of_day_color_t, {
+    float r;
+    float g;
+    float b;
+});
+
+// Lighting for a given height of the sun, where -1 is midnight and 1 is noon.
+FLECS_GAME_CORE_API
+ECS_STRUCT(ecs_time_of_day_key_t, {
+    float sun_height;
+    ecs_time_of_day_color_t sun_color;
+    float sun_intensity;
+    ecs_time_of_day_color_t ambient_color;
+});
+
+// Singleton that configures the day cycle. Keys must be sorted by sun height.
+// When set, the curve is baked into the TimeOfDayTable singleton.
+FLECS_GAME_CORE_API
+ECS_STRUCT(EcsTimeOfDayCurve, {
+    int32_t count;
+    ecs_time_of_day_key_t keys[8];
+});
+
+typedef struct ecs_time_of_day_sample_t {
+    vec3 sun_color;
+    float sun_intensity;
+    vec3 ambient_color;
+} ecs_time_of_day_sample_t;
+
+// Singleton with lookup table for the current day cycle. The last sample is a
+// copy of the first so lookups can interpolate without wrapping.
+typedef struct EcsTimeOfDayTable {
+    ecs_time_of_day_sample_t samples[FLECS_GAME_TIME_OF_DAY_LUT_SIZE + 1];
+} EcsTimeOfDayTable;
+
+FLECS_GAME_CORE_API
+extern ECS_COMPONENT_DECLARE(EcsTimeOfDayTable);
+
+FLECS_GAME_CORE_API
+extern ECS_DECLARE(EcsWorldCell);
+
+FLECS_GAME_CORE_API
+extern ECS_DECLARE(EcsWorldCellRoot);
+
+FLECS_GAME_CORE_API
+ECS_STRUCT(EcsWorldCellCoord, {
+    int64_t x;
+    int64_t y;
+    int32_t size;
+});
+
+FLECS_GAME_CORE_API
+ECS_STRUCT(ecs_grid_slot_t, {
+    ecs_entity_t prefab;
+    float chance;
+});
+
+FLECS_GAME_CORE_API
+ECS_STRUCT(ecs_grid_coord_t, {
+    int32_t count;
+    float spacing;
+    float variation;
+});
+
+FLECS_GAME_CORE_API
+ECS_STRUCT(EcsGrid, {
+    ecs_grid_coord_t x;
+    ecs_grid_coord_t y;
+    ecs_grid_coord_t z;
+
+    EcsPosition3 border;
+    EcsPosition3 border_offset;
+
+    ecs_entity_t prefab;
+    ecs_grid_slot_t variations[20];
+});
+
+// Generate the tiles of a grid over multiple frames. Add to the grid entity
+// before setting Grid. Every frame at most tiles_per_frame tiles are created,
+// and generation stops when it took longer than time_budget seconds. A value
+// of 0 disables the respective limit.
+FLECS_GAME_CORE_API
+ECS_STRUCT(EcsGridAsync, {
+    int32_t tiles_per_frame;
+    float time_budget;
+});
+
+// Added to a grid entity when all of its tiles have been created.
+FLECS_GAME_CORE_API
+extern ECS_DECLARE(EcsGridReady);
+
+// Flow fields divide world cells in nav tiles. The number of tiles per world
+// cell side is 1 << FLECS_GAME_NAV_TILE_SHIFT.
+#define FLECS_GAME_NAV_TILE_SHIFT (3)
+
+// Size of a nav tile
+#define FLECS_GAME_NAV_TILE_SIZE \
+    (FLECS_GAME_WORLD_CELL_SIZE >> FLECS_GAME_NAV_TILE_SHIFT)
+
+// Entity with a Position3 that adds cost to the nav tile that contains it. A
+// cost of 0 makes the tile impassable. Obstacles are found through the world
+// cell they are in, so they can't be children of entities with a Position3.
+FLECS_GAME_CORE_API
+ECS_STRUCT(EcsNavObstacle, {
+    float cost;
+});
+
+// Flow field towards the entity it is added to, which must have a Position3.
+// The field covers the world cells within radius (in cells) of the cell that
+// contains the goal. It is recomputed when the goal moves to another nav tile.
+// When an obstacle in one of its cells changes, only the tiles of which the
+// distance depends on the changed tiles are updated. Nav tiles subdivide world
+// cells, so the tiles of a field line up with cell bounds. Agents steer with
+// ecs_flow_field_direction.
+FLECS_GAME_CORE_API
+ECS_STRUCT(EcsFlowField, {
+    int32_t radius;
+});
+
+// Area of interest of an observer entity with a Position3, such as a player or
+// camera. Resolves to the world cells within radius of the observer. Every frame
+// the cells that entered or left the area and the member tables that changed
+// are diffed against the entities the observer knows about, which can be
+// retrieved with ecs_interest_enter, ecs_interest_leave and ecs_interest_update.
+FLECS_GAME_CORE_API
+ECS_STRUCT(EcsInterestArea, {
+    float radius;
+});
+
+// Singleton that enables sorting of entities within tables in Z-order of their
+// position in the world cell, so that entities that are close to each other
+// are also close in component storage. A pass over all tables is started when
+// migration_threshold entities have changed cells since the last pass, and
+// sorts at most tables_per_frame tables per frame (0 is no limit).
+FLECS_GAME_CORE_API
+ECS_STRUCT(EcsWorldCellSort, {
+    int32_t migration_threshold;
+    int32_t tables_per_frame;
+});
+
+// Singleton with performance counters of the world cell and grid code. Cell
+// counters and times are for the last completed frame, grid counters are for
+// the last generated grid. Each time field measures the system it is named
+// after, grid_time measures SetGrid or GridGenerateStep. Times are in seconds,
+// for async grids grid_time is the sum of the time spent in each frame.
+FLECS_GAME_CORE_API
+ECS_STRUCT(EcsGameStats, {
+    int32_t cell_count;
+    int32_t cells_created;
+    int32_t cell_migrations;
+    int64_t cells_created_total;
+    int64_t cell_migrations_total;
+    float update_world_cell_time;
+    float world_cell_sort_time;
+    int32_t grid_tiles;
+    int64_t grid_tiles_total;
+    float grid_time;
+    float grid_tiles_per_second;
+});
+
+// Get signed index of the world cell that contains coordinate v.
+FLECS_GAME_CORE_API
+int32_t ecs_world_cell_index(
+    float v);
+
+// Get lower bound of the world cell at signed index. Cell indices are computed
+// from truncated coordinates, so cell 0 spans (-1, SIZE) and cell -1 spans
+// (-SIZE, -1]. Other cells span SIZE units from their lower bound.
+FLECS_GAME_CORE_API
+float ecs_world_cell_lower(
+    int32_t index);
+
+// Get world cell at signed cell index. Returns 0 if the cell doesn't exist.
+FLECS_GAME_CORE_API
+ecs_entity_t ecs_world_cell_get(
+    const ecs_world_t *world,
+    int32_t x,
+    int32_t y);
+
+// Find world cell that contains position (x, y). Returns 0 if the cell doesn't
+// exist. The y coordinate corresponds with the z axis of Position3.
+FLECS_GAME_CORE_API
+ecs_entity_t ecs_world_cell_find(
+    const ecs_world_t *world,
+    float x,
+    float y);
+
+// Sample the time of day lookup table at time of day t.
+FLECS_GAME_CORE_API
+void ecs_time_of_day_sample(
+    const EcsTimeOfDayTable *table,
+    float t,
+    ecs_time_of_day_sample_t *out);
+
+// Angle of the sun at time of day t.
+FLECS_GAME_CORE_API
+float ecs_time_of_day_sun_angle(
+    float t);
+
+// Get direction towards the goal of a flow field for an agent at (x, y). The
+// direction (dx, dy) is normalized, and is 0 when the agent is at the goal.
+// Returns false if (x, y) is outside of the field or can't reach the goal. The
+// y coordinate corresponds with the z axis of Position3.
+FLECS_GAME_CORE_API
+bool ecs_flow_field_direction(
+    const ecs_world_t *world,
+    ecs_entity_t field,
+    float x,
+    float y,
+    float *dx_out,
+    float *dy_out);
+
+// Entities that entered the interest area of observer in the last frame.
+FLECS_GAME_CORE_API
+const ecs_entity_t* ecs_interest_enter(
+    const ecs_world_t *world,
+    ecs_entity_t observer,
+    int32_t *count_out);
+
+// Entities that left the interest area of observer in the last frame, either
+// because they moved out of it or because they were deleted.
+FLECS_GAME_CORE_API
+const ecs_entity_t* ecs_interest_leave(
+    const ecs_world_t *world,
+    ecs_entity_t observer,
+    int32_t *count_out);
+
+// Entities that stayed in the interest area of observer, and that are stored in
+// a table in which Position3 changed in the last frame.
+FLECS_GAME_CORE_API
+const ecs_entity_t* ecs_interest_update(
+    const ecs_world_t *world,
+    ecs_entity_t observer,
+    int32_t *count_out);
+
+typedef struct ecs_world_cell_ray_t ecs_world_cell_ray_t;
+
+// Narrow test for raycasts. Called for each table with members in a world cell
+// that the ray crosses. Returns the index in it->entities of the closest member
+// that is hit at less than distance, and sets distance to the hit distance.
+// Returns -1 if no member in the table was hit.
+typedef int32_t (*ecs_world_cell_ray_test_t)(
+    ecs_iter_t *it,
+    const ecs_world_cell_ray_t *ray,
+    float *distance);
+
+struct ecs_world_cell_ray_t {
+    EcsPosition3 origin;
+    EcsPosition3 direction;       // Normalized
+    float max_distance;           // Must be finite
+    ecs_world_cell_ray_test_t test;
+    void *ctx;                    // Passed to test through ray
+    bool any;                     // Stop at the first hit instead of the closest
+};
+
+typedef struct ecs_world_cell_ray_hit_t {
+    ecs_entity_t entity;
+    float distance;
+} ecs_world_cell_ray_hit_t;
+
+// Cast a ray through the world cells it crosses in the XZ plane, in order of
+// distance. Cells that don't exist or have no members are skipped without
+// calling the test. Members are tested in the cell that contains their
+// position, so members that extend into a crossed cell from a cell that the
+// ray doesn't cross are not found. Returns whether a member was hit.
+FLECS_GAME_CORE_API
+bool ecs_world_cell_raycast(
+    const ecs_world_t *world,
+    const ecs_world_cell_ray_t *ray,
+    ecs_world_cell_ray_hit_t *hit_out);
+
+// Returns whether no member between from and to is hit by the test. Stops at
+// the first hit.
+FLECS_GAME_CORE_API
+bool ecs_world_cell_line_of_sight(
+    const ecs_world_t *world,
+    const EcsPosition3 *from,
+    const EcsPosition3 *to,
+    ecs_world_cell_ray_test_t test,
+    void *ctx);
+
+// Save world cells and the tiles of named grids to a binary snapshot.
+FLECS_GAME_CORE_API
+int ecs_game_snapshot_save(
+    const ecs_world_t *world,
+    const char *filename);
+
+// Restore snapshot. Cells and grids that already exist with the same
+// parameters are not recreated. Grid prefabs are looked up by path, so they
+// must exist before restoring. Must not be called while the world is deferred.
+FLECS_GAME_CORE_API
+int ecs_game_snapshot_restore(
+    ecs_world_t *world,
+    const char *filename);
+
+// Import simulation part of the module (world cells, grids, time of day). Does
+// not depend on the graphics, gui and input modules.
+FLECS_GAME_CORE_API
+void FlecsGameCoreImport(ecs_world_t *world);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+#ifndef FLECS_NO_CPP
+#include <initializer_list>
+
+namespace flecs {
+
+// Core module, imported with world.import<flecs::game_core>(). Also provides
+// spatial queries on world cells. The callback is invoked with an entity and a
+// reference to each of the requested components:
+//
+//   flecs::game::each_in_radius<Health>(world, pos, 10,
+//       [](flecs::entity e, Health& h) { ... });
+//
+// Component columns are fetched once per table, and the callback is inlined in
+// the loop. Tables that don't own all requested components are skipped.
+struct game_core {
+    game_core(flecs::world& ecs) {
+        // Load module contents
+        FlecsGameCoreImport(ecs);
+
+        // Bind C++ types of the transform components used by the queries
+        ecs.import<flecs::components::transform>();
+
+        // Bind C++ types with module contents
+        ecs.module<flecs::game_core>();
+    }
+
+    // Iterate entities in world cell.
+    template <typename ... Components, typename Func>
+    static void each_in_cell(
+        flecs::world_t *world,
+        flecs::entity_t cell,
+        const Func& func)
+    {
+        ecs_iter_t it = cell_iter(world, cell);
+        while (ecs_term_next(&it)) {
+            each_row(world, it, func, column<Components>(world, it)...);
+        }
+    }
+
+    // Iterate entities with a Position3 within radius of center.
+    template <typename ... Components, typename Func>
+    static void each_in_radius(
+        flecs::world_t *world,
+        const EcsPosition3& center,
+        float radius,
+        const Func& func)
+    {
+        int32_t x_min = ecs_world_cell_index(center.x - radius);
+        int32_t x_max = ecs_world_cell_index(center.x + radius);
+        int32_t y_min = ecs_world_cell_index(center.z - radius);
+        int32_t y_max = ecs_world_cell_index(center.z + radius);
+        float radius_sqr = radius * radius;
+
+        for (int32_t x = x_min; x <= x_max; x ++) {
+            for (int32_t y = y_min; y <= y_max; y ++) {
+                flecs::entity_t cell = ecs_world_cell_get(world, x, y);
+                if (!cell) {
+                    continue;
+                }
+
+                ecs_iter_t it = cell_iter(world, cell);
+                while (ecs_term_next(&it)) {
+                    const EcsPosition3 *p = column<const EcsPosition3>(world, it);
+                    if (p) {
+                        each_row_in_radius(world, it, func, p, center,
+                            radius_sqr, column<Components>(world, it)...);
+                    }
+                }
+            }
+        }
+    }
+
+protected:
+    // Used by modules that import the core module through their C import
+    game_core() { }
+
+private:
+    static ecs_iter_t cell_iter(
+        flecs::world_t *world,
+        flecs::entity_t cell)
+    {
+        ecs_term_t term = {};
+        term.id = ecs_pair(EcsWorldCell, cell);
+        return ecs_term_iter(world, &term);
+    }
+
+    template <typename T>
+    static T* column(
+        flecs::world_t *world,
+        const ecs_iter_t& it)
+    {
+        return static_cast<T*>(ecs_table_get_id(world, it.table,
+            _::cpp_type<T>::id(world), it.offset));
+    }
+
+    template <typename ... Ptrs>
+    static bool all_owned(
+        Ptrs... ptrs)
+    {
+        bool result = true;
+        (void)std::initializer_list<bool>{ (result = result && ptrs)... };
+        return result;
+    }
+
+    template <typename Func, typename ... Ptrs>
+    static void each_row(
+        flecs::world_t *world,
+        const ecs_iter_t& it,
+        const Func& func,
+        Ptrs... ptrs)
+    {
+        if (!all_owned(ptrs...)) {
+            return;
+        }
+
+        for (int32_t i = 0; i < it.count; i ++) {
+            func(flecs::entity(world, it.entities[i]), ptrs[i]...);
+        }
+    }
+
+    template <typename Func, typename ... Ptrs>
+    static void each_row_in_radius(
+        flecs::world_t *world,
+        const ecs_iter_t& it,
+        const Func& func,
+        const EcsPosition3 *p,
+        const EcsPosition3& center,
+        float radius_sqr,
+        Ptrs... ptrs)
+    {
+        if (!all_owned(ptrs...)) {
+            return;
+        }
+
+        for (int32_t i = 0; i < it.count; i ++) {
+            float dx = p[i].x - center.x;
+            float dy = p[i].y - center.y;
+            float dz = p[i].z - center.z;
+            if ((dx * dx + dy * dy + dz * dz) <= radius_sqr) {
+                func(flecs::entity(world, it.entities[i]), ptrs[i]...);
+            }
+        }
+    }
+};
+
+}
+
+#endif
+#endif
+
+#endif
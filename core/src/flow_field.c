@@ -0,0 +1,798 @@
+#include <flecs_game_core.h>
+#include <float.h>
+
+#define NAV_TILE_SIZE ((float)FLECS_GAME_NAV_TILE_SIZE)
+#define NAV_TILES_PER_CELL (1 << FLECS_GAME_NAV_TILE_SHIFT)
+#define NAV_BLOCKED (-1.0f)
+#define NAV_NO_DIRECTION (-1)
+#define NAV_EPSILON (0.0001f)
+
+ECS_COMPONENT_DECLARE(FlowField);
+
+/* Cost, distance and direction grids of a flow field. The grid covers a square
+ * region of nav tiles, starting at tile (x, y). */
+typedef struct FlowField {
+    int32_t x;
+    int32_t y;
+    int32_t size;
+    int32_t goal_x;
+    int32_t goal_y;
+    int32_t radius;
+    ecs_vec_t cost;        /* vector<float>, NAV_BLOCKED if impassable */
+    ecs_vec_t dist;        /* vector<float> */
+    ecs_vec_t dir;         /* vector<int8_t>, index in flow_neighbors */
+    bool valid;
+} FlowField;
+
+typedef struct {
+    float dist;
+    int32_t tile;
+} flow_node_t;
+
+/* Obstacles are tracked by the world cell that contains them, so that a change
+ * only invalidates the fields that cover the old or new cell of an obstacle. */
+typedef struct {
+    ecs_query_t *obstacles;
+    ecs_map_t cells;       /* map<entity, cell key> of known obstacles */
+    ecs_map_t dirty;       /* set<cell key> with changed obstacles */
+} flecs_game_flow_ctx_t;
+
+static const int32_t flow_neighbors[8][2] = {
+    {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, 1}, {1, -1}, {-1, -1}
+};
+
+static const float flow_neighbor_cost[8] = {
+    1, 1, 1, 1, GLM_SQRT2, GLM_SQRT2, GLM_SQRT2, GLM_SQRT2
+};
+
+static ECS_DTOR(FlowField, ptr, {
+    ecs_vec_fini_t(NULL, &ptr->cost, float);
+    ecs_vec_fini_t(NULL, &ptr->dist, float);
+    ecs_vec_fini_t(NULL, &ptr->dir, int8_t);
+})
+
+static ECS_MOVE(FlowField, dst, src, {
+    ecs_vec_fini_t(NULL, &dst->cost, float);
+    ecs_vec_fini_t(NULL, &dst->dist, float);
+    ecs_vec_fini_t(NULL, &dst->dir, int8_t);
+    *dst = *src;
+    ecs_os_zeromem(src);
+})
+
+static
+void flecs_game_flow_ctx_free(
+    void *ptr)
+{
+    flecs_game_flow_ctx_t *ctx = ptr;
+    ecs_map_fini(&ctx->cells);
+    ecs_map_fini(&ctx->dirty);
+    ecs_os_free(ctx);
+}
+
+static
+uint64_t flecs_game_flow_cell_key(
+    int32_t x,
+    int32_t y)
+{
+    return ((uint64_t)(uint32_t)x << 32) | (uint64_t)(uint32_t)y;
+}
+
+/* Nav tiles subdivide world cells, so that the tiles of a cell line up with the
+ * cell bounds. Cells 0 and -1 are one unit wider and narrower than other cells,
+ * so the first and last tile of those cells are adjusted by one unit. */
+static
+int32_t flecs_game_nav_tile(
+    float v)
+{
+    int32_t cell = ecs_world_cell_index(v);
+    int32_t tile = (int32_t)((v - ecs_world_cell_lower(cell)) / NAV_TILE_SIZE);
+    if (tile < 0) {
+        tile = 0;
+    } else if (tile >= NAV_TILES_PER_CELL) {
+        tile = NAV_TILES_PER_CELL - 1;
+    }
+    return cell * NAV_TILES_PER_CELL + tile;
+}
+
+static
+void flow_heap_push(
+    ecs_vec_t *heap,
+    float dist,
+    int32_t tile)
+{
+    flow_node_t *nodes;
+    int32_t i = ecs_vec_count(heap);
+    ecs_vec_append_t(NULL, heap, flow_node_t);
+    nodes = ecs_vec_first_t(heap, flow_node_t);
+
+    while (i > 0) {
+        int32_t parent = (i - 1) / 2;
+        if (nodes[parent].dist <= dist) {
+            break;
+        }
+        nodes[i] = nodes[parent];
+        i = parent;
+    }
+
+    nodes[i] = (flow_node_t){ dist, tile };
+}
+
+static
+flow_node_t flow_heap_pop(
+    ecs_vec_t *heap)
+{
+    flow_node_t *nodes = ecs_vec_first_t(heap, flow_node_t);
+    int32_t count = ecs_vec_count(heap) - 1;
+    flow_node_t result = nodes[0];
+    flow_node_t last = nodes[count];
+    ecs_vec_remove_last(heap);
+
+    int32_t i = 0;
+    while (true) {
+        int32_t child = i * 2 + 1;
+        if (child >= count) {
+            break;
+        }
+        if (child + 1 < count && nodes[child + 1].dist < nodes[child].dist) {
+            child ++;
+        }
+        if (last.dist <= nodes[child].dist) {
+            break;
+        }
+        nodes[i] = nodes[child];
+        i = child;
+    }
+
+    if (count) {
+        nodes[i] = last;
+    }
+
+    return result;
+}
+
+static
+int32_t flow_field_goal(
+    const FlowField *ff)
+{
+    return (ff->goal_x - ff->x) + (ff->goal_y - ff->y) * ff->size;
+}
+
+/* Reset the cost of the tiles of a world cell, and rasterize the obstacles in
+ * the cell. Obstacles are found through the world cell pair of their table. */
+static
+void flow_cell_costs(
+    ecs_world_t *world,
+    FlowField *ff,
+    int32_t cell_x,
+    int32_t cell_y)
+{
+    float *cost = ecs_vec_first_t(&ff->cost, float);
+    int32_t x0 = cell_x * NAV_TILES_PER_CELL - ff->x;
+    int32_t y0 = cell_y * NAV_TILES_PER_CELL - ff->y;
+    int32_t i, x, y;
+
+    for (y = y0; y < y0 + NAV_TILES_PER_CELL; y ++) {
+        for (x = x0; x < x0 + NAV_TILES_PER_CELL; x ++) {
+            cost[x + y * ff->size] = 1;
+        }
+    }
+
+    ecs_entity_t cell = ecs_world_cell_get(world, cell_x, cell_y);
+    if (!cell) {
+        return;
+    }
+
+    ecs_iter_t it = ecs_term_iter(world, &(ecs_term_t){
+        .id = ecs_pair(EcsWorldCell, cell)
+    });
+
+    while (ecs_term_next(&it)) {
+        const EcsNavObstacle *o = ecs_table_get_id(world, it.table,
+            ecs_id(EcsNavObstacle), it.offset);
+        const EcsPosition3 *p = ecs_table_get_id(world, it.table,
+            ecs_id(EcsPosition3), it.offset);
+        if (!o || !p) {
+            continue;
+        }
+
+        for (i = 0; i < it.count; i ++) {
+            x = flecs_game_nav_tile(p[i].x) - ff->x;
+            y = flecs_game_nav_tile(p[i].z) - ff->y;
+            if (x < 0 || y < 0 || x >= ff->size || y >= ff->size) {
+                continue;
+            }
+
+            float *c = &cost[x + y * ff->size];
+            if (o[i].cost <= 0) {
+                *c = NAV_BLOCKED;
+            } else if (*c != NAV_BLOCKED) {
+                *c += o[i].cost;
+            }
+        }
+    }
+}
+
+/* Returns whether a move in direction n from tile (x, y) cuts the corner of a
+ * blocked tile. */
+static
+bool flow_corner_blocked(
+    const float *cost,
+    int32_t size,
+    int32_t x,
+    int32_t y,
+    int32_t n)
+{
+    if (n < 4) {
+        return false;
+    }
+
+    int32_t nx = x + flow_neighbors[n][0];
+    int32_t ny = y + flow_neighbors[n][1];
+    return cost[nx + y * size] == NAV_BLOCKED ||
+        cost[x + ny * size] == NAV_BLOCKED;
+}
+
+/* Dijkstra from the tiles in the heap. Tiles that get a lower distance are
+ * appended to updated, if provided. */
+static
+void flow_field_propagate(
+    FlowField *ff,
+    ecs_vec_t *heap,
+    ecs_vec_t *updated)
+{
+    int32_t size = ff->size;
+    float *cost = ecs_vec_first_t(&ff->cost, float);
+    float *dist = ecs_vec_first_t(&ff->dist, float);
+
+    while (ecs_vec_count(heap)) {
+        flow_node_t node = flow_heap_pop(heap);
+        if (node.dist > dist[node.tile]) {
+            continue; /* Stale entry */
+        }
+
+        int32_t x = node.tile % size, y = node.tile / size;
+        for (int32_t n = 0; n < 8; n ++) {
+            int32_t nx = x + flow_neighbors[n][0];
+            int32_t ny = y + flow_neighbors[n][1];
+            if (nx < 0 || ny < 0 || nx >= size || ny >= size) {
+                continue;
+            }
+
+            int32_t tile = nx + ny * size;
+            if (cost[tile] == NAV_BLOCKED) {
+                continue;
+            }
+
+            /* Don't cut corners of blocked tiles */
+            if (flow_corner_blocked(cost, size, x, y, n)) {
+                continue;
+            }
+
+            float d = node.dist + cost[tile] * flow_neighbor_cost[n];
+            if (d < dist[tile]) {
+                dist[tile] = d;
+                flow_heap_push(heap, d, tile);
+                if (updated) {
+                    ecs_vec_append_t(NULL, updated, int32_t)[0] = tile;
+                }
+            }
+        }
+    }
+}
+
+/* Point tile to its cheapest neighbor */
+static
+void flow_tile_dir(
+    FlowField *ff,
+    int32_t tile)
+{
+    int32_t size = ff->size;
+    const float *cost = ecs_vec_first_t(&ff->cost, float);
+    const float *dist = ecs_vec_first_t(&ff->dist, float);
+    int8_t *dir = ecs_vec_first_t(&ff->dir, int8_t);
+    int32_t x = tile % size, y = tile / size;
+
+    dir[tile] = NAV_NO_DIRECTION;
+    if (dist[tile] == FLT_MAX || tile == flow_field_goal(ff)) {
+        return;
+    }
+
+    float best = dist[tile];
+    for (int32_t n = 0; n < 8; n ++) {
+        int32_t nx = x + flow_neighbors[n][0];
+        int32_t ny = y + flow_neighbors[n][1];
+        if (nx < 0 || ny < 0 || nx >= size || ny >= size) {
+            continue;
+        }
+        if (flow_corner_blocked(cost, size, x, y, n)) {
+            continue;
+        }
+
+        float d = dist[nx + ny * size];
+        if (d < best) {
+            best = d;
+            dir[tile] = (int8_t)n;
+        }
+    }
+}
+
+/* Dijkstra from the goal tile, then point each tile to its cheapest neighbor */
+static
+void flow_field_solve(
+    FlowField *ff)
+{
+    int32_t i, count = ff->size * ff->size;
+    float *cost = ecs_vec_first_t(&ff->cost, float);
+    float *dist = ecs_vec_first_t(&ff->dist, float);
+    int8_t *dir = ecs_vec_first_t(&ff->dir, int8_t);
+    for (i = 0; i < count; i ++) {
+        dist[i] = FLT_MAX;
+        dir[i] = NAV_NO_DIRECTION;
+    }
+
+    int32_t goal = flow_field_goal(ff);
+    if (cost[goal] == NAV_BLOCKED) {
+        return;
+    }
+
+    ecs_vec_t heap = {0};
+    dist[goal] = 0;
+    flow_heap_push(&heap, 0, goal);
+    flow_field_propagate(ff, &heap, NULL);
+    ecs_vec_fini_t(NULL, &heap, flow_node_t);
+
+    for (i = 0; i < count; i ++) {
+        flow_tile_dir(ff, i);
+    }
+}
+
+static
+void flow_field_build(
+    ecs_world_t *world,
+    const EcsFlowField *config,
+    FlowField *ff,
+    int32_t goal_x,
+    int32_t goal_y)
+{
+    int32_t radius = glm_max(0, config->radius);
+    int32_t goal_cell_x = goal_x >> FLECS_GAME_NAV_TILE_SHIFT;
+    int32_t goal_cell_y = goal_y >> FLECS_GAME_NAV_TILE_SHIFT;
+    int32_t size = (2 * radius + 1) * NAV_TILES_PER_CELL;
+    int32_t count = size * size;
+
+    ff->x = (goal_cell_x - radius) * NAV_TILES_PER_CELL;
+    ff->y = (goal_cell_y - radius) * NAV_TILES_PER_CELL;
+    ff->size = size;
+    ff->goal_x = goal_x;
+    ff->goal_y = goal_y;
+    ff->radius = config->radius;
+    ff->valid = true;
+
+    ecs_vec_set_count_t(NULL, &ff->cost, float, count);
+    ecs_vec_set_count_t(NULL, &ff->dist, float, count);
+    ecs_vec_set_count_t(NULL, &ff->dir, int8_t, count);
+
+    for (int32_t y = goal_cell_y - radius; y <= goal_cell_y + radius; y ++) {
+        for (int32_t x = goal_cell_x - radius; x <= goal_cell_x + radius; x ++) {
+            flow_cell_costs(world, ff, x, y);
+        }
+    }
+
+    flow_field_solve(ff);
+}
+
+/* Clear the distance of a tile, and store its old distance in invalidated.
+ * Tiles that weren't reachable are only added if their cost changed, as they
+ * may be reachable now. */
+static
+void flow_tile_invalidate(
+    FlowField *ff,
+    ecs_vec_t *invalidated,
+    int32_t tile,
+    bool cost_changed)
+{
+    float *dist = ecs_vec_get_t(&ff->dist, float, tile);
+    if (tile == flow_field_goal(ff)) {
+        return; /* Distance of the goal doesn't depend on other tiles */
+    }
+    if (*dist == FLT_MAX && !cost_changed) {
+        return;
+    }
+
+    ecs_vec_append_t(NULL, invalidated, flow_node_t)[0] = 
+        (flow_node_t){ *dist, tile };
+    *dist = FLT_MAX;
+}
+
+/* Update a field for the obstacles in changed world cells. Tiles of which the
+ * cost changed, their neighbors (as blocked tiles change which diagonal moves
+ * are allowed) and the tiles that were reached through them are invalidated,
+ * and are propagated again from the tiles around them that are still valid.
+ * Returns whether the field changed. */
+static
+bool flow_field_update(
+    ecs_world_t *world,
+    FlowField *ff,
+    const ecs_vec_t *cells)
+{
+    int32_t size = ff->size;
+    int32_t goal = flow_field_goal(ff);
+    float *cost = ecs_vec_first_t(&ff->cost, float);
+    bool goal_blocked = cost[goal] == NAV_BLOCKED;
+    float old[NAV_TILES_PER_CELL * NAV_TILES_PER_CELL];
+    ecs_vec_t invalidated = {0}; /* vector<flow_node_t>, old tile distances */
+    int32_t i, c, n, x, y;
+
+    const uint64_t *keys = ecs_vec_first_t(cells, uint64_t);
+    for (c = 0; c < ecs_vec_count(cells); c ++) {
+        int32_t cell_x = (int32_t)(uint32_t)(keys[c] >> 32);
+        int32_t cell_y = (int32_t)(uint32_t)keys[c];
+        int32_t x0 = cell_x * NAV_TILES_PER_CELL - ff->x;
+        int32_t y0 = cell_y * NAV_TILES_PER_CELL - ff->y;
+
+        for (i = 0; i < NAV_TILES_PER_CELL * NAV_TILES_PER_CELL; i ++) {
+            x = x0 + i % NAV_TILES_PER_CELL;
+            y = y0 + i / NAV_TILES_PER_CELL;
+            old[i] = cost[x + y * size];
+        }
+
+        flow_cell_costs(world, ff, cell_x, cell_y);
+
+        for (i = 0; i < NAV_TILES_PER_CELL * NAV_TILES_PER_CELL; i ++) {
+            x = x0 + i % NAV_TILES_PER_CELL;
+            y = y0 + i / NAV_TILES_PER_CELL;
+            if (old[i] == cost[x + y * size]) {
+                continue;
+            }
+
+            flow_tile_invalidate(ff, &invalidated, x + y * size, true);
+            for (n = 0; n < 8; n ++) {
+                int32_t nx = x + flow_neighbors[n][0];
+                int32_t ny = y + flow_neighbors[n][1];
+                if (nx >= 0 && ny >= 0 && nx < size && ny < size) {
+                    flow_tile_invalidate(
+                        ff, &invalidated, nx + ny * size, false);
+                }
+            }
+        }
+    }
+
+    /* All distances depend on whether the goal is blocked */
+    if (goal_blocked != (cost[goal] == NAV_BLOCKED)) {
+        ecs_vec_fini_t(NULL, &invalidated, flow_node_t);
+        flow_field_solve(ff);
+        return true;
+    }
+
+    /* A tile was reached through an invalidated tile if its distance equals
+     * the distance through that tile. Invalidating ties is conservative. */
+    float *dist = ecs_vec_first_t(&ff->dist, float);
+    for (i = 0; i < ecs_vec_count(&invalidated); i ++) {
+        flow_node_t node = ecs_vec_get_t(&invalidated, flow_node_t, i)[0];
+        if (node.dist == FLT_MAX) {
+            continue;
+        }
+
+        x = node.tile % size;
+        y = node.tile / size;
+        for (n = 0; n < 8; n ++) {
+            int32_t nx = x + flow_neighbors[n][0];
+            int32_t ny = y + flow_neighbors[n][1];
+            if (nx < 0 || ny < 0 || nx >= size || ny >= size) {
+                continue;
+            }
+
+            int32_t tile = nx + ny * size;
+            float d = node.dist + cost[tile] * flow_neighbor_cost[n];
+            if (dist[tile] != FLT_MAX && dist[tile] >= d * (1 - NAV_EPSILON)) {
+                flow_tile_invalidate(ff, &invalidated, tile, false);
+            }
+        }
+    }
+
+    int32_t count = ecs_vec_count(&invalidated);
+    if (!count) {
+        ecs_vec_fini_t(NULL, &invalidated, flow_node_t);
+        return false;
+    }
+
+    /* Seed invalidated tiles with their distance through valid neighbors */
+    ecs_vec_t heap = {0}, updated = {0};
+    flow_node_t *nodes = ecs_vec_first_t(&invalidated, flow_node_t);
+    for (i = 0; i < count; i ++) {
+        int32_t tile = nodes[i].tile;
+        if (cost[tile] == NAV_BLOCKED) {
+            continue;
+        }
+
+        x = tile % size;
+        y = tile / size;
+        float best = FLT_MAX;
+        for (n = 0; n < 8; n ++) {
+            int32_t nx = x + flow_neighbors[n][0];
+            int32_t ny = y + flow_neighbors[n][1];
+            if (nx < 0 || ny < 0 || nx >= size || ny >= size) {
+                continue;
+            }
+
+            float nd = dist[nx + ny * size];
+            if (nd == FLT_MAX || flow_corner_blocked(cost, size, x, y, n)) {
+                continue;
+            }
+
+            best = glm_min(best, nd + cost[tile] * flow_neighbor_cost[n]);
+        }
+
+        if (best < FLT_MAX) {
+            dist[tile] = best;
+            flow_heap_push(&heap, best, tile);
+        }
+    }
+
+    flow_field_propagate(ff, &heap, &updated);
+    ecs_vec_fini_t(NULL, &heap, flow_node_t);
+
+    /* Directions depend on the distance of neighbors */
+    const int32_t *tiles = ecs_vec_first_t(&updated, int32_t);
+    int32_t updated_count = ecs_vec_count(&updated);
+    for (i = 0; i < count + updated_count; i ++) {
+        int32_t tile = i < count ? nodes[i].tile : tiles[i - count];
+        x = tile % size;
+        y = tile / size;
+        flow_tile_dir(ff, tile);
+        for (n = 0; n < 8; n ++) {
+            int32_t nx = x + flow_neighbors[n][0];
+            int32_t ny = y + flow_neighbors[n][1];
+            if (nx >= 0 && ny >= 0 && nx < size && ny < size) {
+                flow_tile_dir(ff, nx + ny * size);
+            }
+        }
+    }
+
+    ecs_vec_fini_t(NULL, &updated, int32_t);
+    ecs_vec_fini_t(NULL, &invalidated, flow_node_t);
+    return true;
+}
+
+bool ecs_flow_field_direction(
+    const ecs_world_t *world,
+    ecs_entity_t field,
+    float x,
+    float y,
+    float *dx_out,
+    float *dy_out)
+{
+    *dx_out = 0;
+    *dy_out = 0;
+
+    const FlowField *ff = ecs_get(world, field, FlowField);
+    if (!ff || !ff->valid) {
+        return false;
+    }
+
+    int32_t tx = flecs_game_nav_tile(x) - ff->x;
+    int32_t ty = flecs_game_nav_tile(y) - ff->y;
+    if (tx < 0 || ty < 0 || tx >= ff->size || ty >= ff->size) {
+        return false;
+    }
+
+    int32_t tile = tx + ty * ff->size;
+    if (tx == ff->goal_x - ff->x && ty == ff->goal_y - ff->y) {
+        return true; /* At goal */
+    }
+
+    int8_t n = ecs_vec_get_t(&ff->dir, int8_t, tile)[0];
+    if (n == NAV_NO_DIRECTION) {
+        return false;
+    }
+
+    float len = flow_neighbor_cost[n];
+    *dx_out = flow_neighbors[n][0] / len;
+    *dy_out = flow_neighbors[n][1] / len;
+    return true;
+}
+
+static
+void flow_cell_dirty(
+    flecs_game_flow_ctx_t *ctx,
+    uint64_t key)
+{
+    ecs_map_ensure(&ctx->dirty, key)[0] = 1;
+}
+
+/* Mark the old and new cells of obstacles in changed tables as dirty */
+static
+void flow_obstacles_update(
+    ecs_world_t *world,
+    flecs_game_flow_ctx_t *ctx)
+{
+    if (!ecs_query_changed(ctx->obstacles, NULL)) {
+        return;
+    }
+
+    ecs_iter_t it = ecs_query_iter(world, ctx->obstacles);
+    while (ecs_query_next_table(&it)) {
+        if (!ecs_query_changed(NULL, &it)) {
+            continue;
+        }
+
+        ecs_query_populate(&it, false);
+        EcsPosition3 *p = ecs_field(&it, EcsPosition3, 1);
+
+        for (int i = 0; i < it.count; i ++) {
+            uint64_t key = flecs_game_flow_cell_key(
+                ecs_world_cell_index(p[i].x), ecs_world_cell_index(p[i].z));
+            uint64_t *cell = ecs_map_get(&ctx->cells, it.entities[i]);
+            if (!cell) {
+                ecs_map_insert(&ctx->cells, it.entities[i], key);
+            } else if (*cell != key) {
+                flow_cell_dirty(ctx, *cell);
+                *cell = key;
+            }
+            flow_cell_dirty(ctx, key);
+        }
+    }
+}
+
+/* Append the cells covered by the field that contain changed obstacles */
+static
+int32_t flow_field_dirty_cells(
+    const flecs_game_flow_ctx_t *ctx,
+    const FlowField *ff,
+    ecs_vec_t *out)
+{
+    int32_t count = ecs_map_count(&ctx->dirty);
+    if (!count) {
+        return 0;
+    }
+
+    int32_t cells = ff->size >> FLECS_GAME_NAV_TILE_SHIFT;
+    int32_t x_min = ff->x >> FLECS_GAME_NAV_TILE_SHIFT;
+    int32_t y_min = ff->y >> FLECS_GAME_NAV_TILE_SHIFT;
+    int32_t x_max = x_min + cells - 1, y_max = y_min + cells - 1;
+
+    if (count < cells * cells) {
+        ecs_map_iter_t mit = ecs_map_iter(&ctx->dirty);
+        while (ecs_map_next(&mit)) {
+            uint64_t key = ecs_map_key(&mit);
+            int32_t x = (int32_t)(uint32_t)(key >> 32);
+            int32_t y = (int32_t)(uint32_t)key;
+            if (x >= x_min && x <= x_max && y >= y_min && y <= y_max) {
+                ecs_vec_append_t(NULL, out, uint64_t)[0] = key;
+            }
+        }
+    } else {
+        for (int32_t y = y_min; y <= y_max; y ++) {
+            for (int32_t x = x_min; x <= x_max; x ++) {
+                uint64_t key = flecs_game_flow_cell_key(x, y);
+                if (ecs_map_get(&ctx->dirty, key)) {
+                    ecs_vec_append_t(NULL, out, uint64_t)[0] = key;
+                }
+            }
+        }
+    }
+
+    return ecs_vec_count(out);
+}
+
+/* Obstacle is removed or deleted, invalidate fields that cover its cell */
+static
+void flow_obstacle_on_remove(
+    ecs_iter_t *it)
+{
+    flecs_game_flow_ctx_t *ctx = it->ctx;
+    for (int i = 0; i < it->count; i ++) {
+        uint64_t *cell = ecs_map_get(&ctx->cells, it->entities[i]);
+        if (cell) {
+            flow_cell_dirty(ctx, *cell);
+            ecs_map_remove(&ctx->cells, it->entities[i]);
+        }
+    }
+}
+
+static
+void UpdateFlowField(ecs_iter_t *it) {
+    ecs_world_t *world = it->world;
+    flecs_game_flow_ctx_t *ctx = it->ctx;
+    ecs_vec_t cells = {0};
+
+    flow_obstacles_update(world, ctx);
+
+    while (ecs_query_next_table(it)) {
+        ecs_query_populate(it, false);
+
+        EcsPosition3 *p = ecs_field(it, EcsPosition3, 1);
+        EcsFlowField *config = ecs_field(it, EcsFlowField, 2);
+        FlowField *ff = ecs_field(it, FlowField, 3);
+        bool changed = false;
+
+        for (int i = 0; i < it->count; i ++) {
+            int32_t goal_x = flecs_game_nav_tile(p[i].x);
+            int32_t goal_y = flecs_game_nav_tile(p[i].z);
+            FlowField *cur = &ff[i];
+
+            if (cur->valid &&
+                cur->goal_x == goal_x && cur->goal_y == goal_y &&
+                cur->radius == config[i].radius)
+            {
+                ecs_vec_clear(&cells);
+                if (flow_field_dirty_cells(ctx, cur, &cells)) {
+                    changed |= flow_field_update(world, cur, &cells);
+                }
+                continue;
+            }
+
+            flow_field_build(world, &config[i], cur, goal_x, goal_y);
+            changed = true;
+        }
+
+        if (!changed) {
+            ecs_query_skip(it);
+        }
+    }
+
+    ecs_vec_fini_t(NULL, &cells, uint64_t);
+    ecs_map_clear(&ctx->dirty);
+}
+
+void FlecsGameFlowFieldImport(ecs_world_t *world) {
+    ECS_COMPONENT_DEFINE(world, FlowField);
+
+    ecs_set_hooks(world, FlowField, {
+        .ctor = ecs_default_ctor,
+        .dtor = ecs_dtor(FlowField),
+        .move = ecs_move(FlowField)
+    });
+
+    ecs_set_hooks(world, EcsFlowField, {
+        .ctor = ecs_default_ctor
+    });
+
+    flecs_game_flow_ctx_t *ctx = ecs_os_calloc_t(flecs_game_flow_ctx_t);
+    ecs_map_init(&ctx->cells, NULL);
+    ecs_map_init(&ctx->dirty, NULL);
+
+    /* The hooks own the context, as they can run during world cleanup after
+     * the system is deleted. */
+    ecs_set_hooks(world, EcsNavObstacle, {
+        .ctor = ecs_default_ctor,
+        .on_remove = flow_obstacle_on_remove,
+        .ctx = ctx,
+        .ctx_free = flecs_game_flow_ctx_free
+    });
+
+    ecs_add_pair(world, ecs_id(EcsFlowField), EcsWith, ecs_id(FlowField));
+
+    ctx->obstacles = ecs_query(world, {
+        .filter.terms = {
+            { .id = ecs_id(EcsPosition3), .inout = EcsIn },
+            { .id = ecs_id(EcsNavObstacle), .inout = EcsIn }
+        }
+    });
+
+    /* Obstacles are found through their world cell, which is assigned by
+     * UpdateWorldCell. The last term makes the pipeline merge the cell
+     * membership before this system runs. */
+    ecs_system(world, {
+        .entity = ecs_entity(world, {
+            .name = "UpdateFlowField",
+            .add = { ecs_dependson(EcsOnValidate) }
+        }),
+        .query.filter.terms = {{
+            .id = ecs_id(EcsPosition3),
+            .inout = EcsIn
+        }, {
+            .id = ecs_id(EcsFlowField),
+            .inout = EcsIn
+        }, {
+            .id = ecs_id(FlowField),
+            .inout = EcsInOut
+        }, {
+            .id = ecs_pair(EcsWorldCell, EcsWildcard),
+            .src.flags = EcsIsEntity,
+            .inout = EcsIn
+        }},
+        .run = UpdateFlowField,
+        .ctx = ctx
+    });
+}
@@ -0,0 +1,353 @@
+#include <flecs_game_core.h>
+
+#define VARIATION_SLOTS_MAX (20)
+
+bool flecs_game_grid_is_restored(
+    ecs_world_t *world,
+    ecs_entity_t grid,
+    const EcsGrid *value);
+
+static
+float randf(float max) {
+    return max * (float)rand() / (float)RAND_MAX;
+}
+
+typedef struct {
+    float x_count;
+    float y_count;
+    float z_count;
+    float x_spacing;
+    float y_spacing;
+    float z_spacing;
+    float x_half;
+    float y_half;
+    float z_half;
+    float x_var;
+    float y_var;
+    float z_var;
+    float variations_total;
+    int32_t variations_count;
+    ecs_entity_t variations[VARIATION_SLOTS_MAX];
+    ecs_entity_t prefab;
+} flecs_grid_params_t;
+
+ecs_entity_t flecs_game_grid_get_prefab(
+    ecs_world_t *world, 
+    ecs_entity_t parent,
+    ecs_entity_t prefab) 
+{
+    if (!prefab) {
+        return 0;
+    }
+
+    /* If prefab is a script/assembly, create a private instance of the
+     * assembly for the grid with default values. This allows applications to
+     * use assemblies directly vs. having to create a dummy prefab */
+    ecs_entity_t result = prefab;
+    if (ecs_has(world, prefab, EcsScript) && ecs_has(world, prefab, EcsComponent)) {
+        result = ecs_new(world, 0);
+        ecs_add_id(world, result, EcsPrefab);
+        ecs_add_id(world, result, prefab);
+    }
+    return result;
+}
+
+static
+ecs_entity_t generate_tile(
+    ecs_world_t *world,
+    const EcsGrid *grid,
+    float xc,
+    float yc,
+    float zc,
+    const flecs_grid_params_t *params)
+{
+    if (params->x_var) {
+        xc += randf(params->x_var) - params->x_var / 2;
+    }
+    if (params->y_var) {
+        yc += randf(params->y_var) - params->y_var / 2;
+    }
+    if (params->z_var) {
+        zc += randf(params->z_var) - params->z_var / 2;
+    }
+
+    ecs_entity_t slot = 0;
+    if (params->prefab) {
+        slot = params->prefab;
+    } else {
+        float p = randf(params->variations_total), cur = 0;
+        for (int v = 0; v < params->variations_count; v ++) {
+            cur += grid->variations[v].chance;
+            if (p <= cur) {
+                slot = params->variations[v];
+                break;
+            }
+        }
+    }
+
+    ecs_entity_t inst = ecs_new_w_pair(world, EcsIsA, slot);
+    ecs_set(world, inst, EcsPosition3, {xc, yc, zc});
+    return inst;
+}
+
+/* Generation state of a grid. Tiles are emitted by linear index, so that
+ * generation can be spread out over multiple frames. */
+typedef struct GridGenerate {
+    flecs_grid_params_t params;
+    bool border;
+    int32_t tile_count;
+    int32_t next;
+    float time;
+} GridGenerate;
+
+ECS_COMPONENT_DECLARE(GridGenerate);
+ECS_DECLARE(EcsGridReady);
+
+/* Returns number of tiles to generate, or 0 if the grid has no prefabs */
+static
+int32_t generate_grid_init(
+    ecs_world_t *world, 
+    ecs_entity_t parent, 
+    const EcsGrid *grid,
+    GridGenerate *gen) 
+{
+    flecs_grid_params_t *params = &gen->params;
+    ecs_os_zeromem(gen);
+
+    params->x_count = glm_max(1, grid->x.count);
+    params->y_count = glm_max(1, grid->y.count);
+    params->z_count = glm_max(1, grid->z.count);
+
+    if (grid->border.x || grid->border.y || grid->border.z) {
+        params->x_spacing = grid->border.x / params->x_count;
+        params->y_spacing = grid->border.y / params->y_count;
+        params->z_spacing = grid->border.z / params->z_count;
+        gen->border = true;
+    } else {
+        params->x_spacing = glm_max(0.001, grid->x.spacing);
+        params->y_spacing = glm_max(0.001, grid->y.spacing);
+        params->z_spacing = glm_max(0.001, grid->z.spacing);
+    }
+
+    params->x_half = ((params->x_count - 1) / 2.0) * params->x_spacing;
+    params->y_half = ((params->y_count - 1) / 2.0) * params->y_spacing;
+    params->z_half = ((params->z_count - 1) / 2.0) * params->z_spacing;
+    
+    params->x_var = grid->x.variation;
+    params->y_var = grid->y.variation;
+    params->z_var = grid->z.variation;
+
+    /* Private prefab instances are created in the scope of the grid */
+    ecs_entity_t old_scope = ecs_set_scope(world, parent);
+
+    ecs_entity_t prefab = grid->prefab;
+    params->variations_total = 0;
+    params->variations_count = 0;
+    if (!prefab) {
+        for (int i = 0; i < VARIATION_SLOTS_MAX; i ++) {
+            if (!grid->variations[i].prefab) {
+                break;
+            }
+            params->variations[i] = flecs_game_grid_get_prefab(world, parent, 
+                grid->variations[i].prefab);
+            params->variations_total += grid->variations[i].chance;
+            params->variations_count ++;
+        }
+    } else {
+        prefab = params->prefab = flecs_game_grid_get_prefab(
+            world, parent, prefab);
+    }
+
+    ecs_set_scope(world, old_scope);
+
+    if (!prefab && !params->variations_count) {
+        return 0;
+    }
+
+    if (!gen->border) {
+        gen->tile_count = params->x_count * params->y_count * params->z_count;
+    } else {
+        gen->tile_count = 2 * (params->x_count + params->z_count);
+    }
+
+    return gen->tile_count;
+}
+
+/* Generate tile at linear index. Indices follow the x, y, z loop order of a
+ * regular grid, or the two x sides followed by the two z sides of a border. */
+static
+void generate_grid_tile(
+    ecs_world_t *world,
+    const EcsGrid *grid,
+    const GridGenerate *gen,
+    int32_t index)
+{
+    const flecs_grid_params_t *params = &gen->params;
+
+    if (!gen->border) {
+        int32_t y_count = params->y_count, z_count = params->z_count;
+        int32_t x = index / (y_count * z_count);
+        int32_t y = (index / z_count) % y_count;
+        int32_t z = index % z_count;
+        float xc = (float)x * params->x_spacing - params->x_half;
+        float yc = (float)y * params->y_spacing - params->y_half;
+        float zc = (float)z * params->z_spacing - params->z_half;
+        generate_tile(world, grid, xc, yc, zc, params);
+        return;
+    }
+
+    int32_t x_tiles = 2 * params->x_count;
+    if (index < x_tiles) {
+        float xc = (float)(index / 2) * params->x_spacing - params->x_half;
+        float zc = grid->border.z / 2 + grid->border_offset.z;
+        generate_tile(world, grid, xc, 0, (index % 2) ? zc : -zc, params);
+    } else {
+        index -= x_tiles;
+        float xc = grid->border.x / 2 + grid->border_offset.x;
+        float zc = (float)(index / 2) * params->z_spacing - params->z_half;
+        ecs_entity_t inst = generate_tile(
+            world, grid, (index % 2) ? -xc : xc, 0, zc, params);
+        ecs_set(world, inst, EcsRotation3, {0, M_PI / 2, 0});
+    }
+}
+
+/* Generate tiles until the grid is done or the budget is exhausted. A budget
+ * of 0 tiles and 0 seconds generates all remaining tiles. Returns whether the
+ * grid is done. */
+static
+bool generate_grid_step(
+    ecs_world_t *world,
+    ecs_entity_t parent,
+    const EcsGrid *grid,
+    GridGenerate *gen,
+    int32_t tile_budget,
+    float time_budget)
+{
+    ecs_time_t t = {0};
+    ecs_time_measure(&t);
+
+    int32_t end = gen->tile_count;
+    if (tile_budget > 0 && (gen->next + tile_budget) < end) {
+        end = gen->next + tile_budget;
+    }
+
+    ecs_entity_t old_scope = ecs_set_scope(world, parent);
+
+    while (gen->next < end) {
+        generate_grid_tile(world, grid, gen, gen->next ++);
+        if (time_budget > 0) {
+            ecs_time_t cur = t;
+            if (ecs_time_measure(&cur) >= time_budget) {
+                break;
+            }
+        }
+    }
+
+    ecs_set_scope(world, old_scope);
+
+    gen->time += ecs_time_measure(&t);
+    return gen->next == gen->tile_count;
+}
+
+static
+void generate_grid_stats(
+    ecs_world_t *world,
+    const GridGenerate *gen)
+{
+    EcsGameStats *stats = ecs_singleton_get_mut(world, EcsGameStats);
+    stats->grid_time = gen->time;
+    stats->grid_tiles = gen->tile_count;
+    stats->grid_tiles_total += gen->tile_count;
+    if (stats->grid_time > 0) {
+        stats->grid_tiles_per_second = gen->tile_count / stats->grid_time;
+    }
+    ecs_singleton_modified(world, EcsGameStats);
+}
+
+static
+void SetGrid(ecs_iter_t *it) {
+    ecs_world_t *world = it->world;
+    EcsGrid *grid = ecs_field(it, EcsGrid, 1);
+
+    for (int i = 0; i < it->count; i ++) {
+        ecs_entity_t g = it->entities[i];
+
+        /* Tiles of restored grids are loaded from the snapshot */
+        if (flecs_game_grid_is_restored(world, g, &grid[i])) {
+            ecs_add(world, g, EcsGridReady);
+            continue;
+        }
+
+        ecs_remove(world, g, EcsGridReady);
+        ecs_remove(world, g, GridGenerate);
+        ecs_delete_with(world, ecs_pair(EcsChildOf, g));
+
+        GridGenerate gen;
+        if (!generate_grid_init(world, g, &grid[i], &gen)) {
+            ecs_add(world, g, EcsGridReady);
+            continue;
+        }
+
+        /* Async grids are generated by the GridGenerate system */
+        if (ecs_has(world, g, EcsGridAsync)) {
+            ecs_set_ptr(world, g, GridGenerate, &gen);
+            continue;
+        }
+
+        generate_grid_step(world, g, &grid[i], &gen, 0, 0);
+        generate_grid_stats(world, &gen);
+        ecs_add(world, g, EcsGridReady);
+    }
+}
+
+static
+void GridGenerateStep(ecs_iter_t *it) {
+    ecs_world_t *world = it->world;
+    EcsGrid *grid = ecs_field(it, EcsGrid, 1);
+    EcsGridAsync *async = ecs_field(it, EcsGridAsync, 2);
+    GridGenerate *gen = ecs_field(it, GridGenerate, 3);
+
+    /* Create tiles directly instead of enqueuing commands, so that the time
+     * budget applies to the actual work of creating the tiles. */
+    bool deferred = ecs_is_deferred(world);
+
+    for (int i = 0; i < it->count; i ++) {
+        ecs_entity_t g = it->entities[i];
+        if (deferred) {
+            ecs_defer_suspend(world);
+        }
+
+        bool done = generate_grid_step(world, g, &grid[i], &gen[i], 
+            async[i].tiles_per_frame, async[i].time_budget);
+
+        if (deferred) {
+            ecs_defer_resume(world);
+        }
+
+        if (done) {
+            generate_grid_stats(world, &gen[i]);
+            ecs_remove(world, g, GridGenerate);
+            ecs_add(world, g, EcsGridReady);
+        }
+    }
+}
+
+void FlecsGameGridImport(ecs_world_t *world) {
+    ECS_COMPONENT_DEFINE(world, GridGenerate);
+    ECS_TAG_DEFINE(world, EcsGridReady);
+
+    ECS_OBSERVER(world, SetGrid, EcsOnSet, Grid);
+
+    /* Creates entities while the system is running, so it can't run while
+     * other systems are iterating tables. Tiles exist when the step returns,
+     * so UpdateWorldCell assigns them to world cells in the same frame. */
+    ecs_system(world, {
+        .entity = ecs_entity(world, {
+            .name = "GridGenerateStep",
+            .add = { ecs_dependson(EcsOnLoad) }
+        }),
+        .query.filter.expr = "[in] Grid, [in] GridAsync, [inout] GridGenerate",
+        .callback = GridGenerateStep,
+        .no_readonly = true
+    });
+}
@@ -0,0 +1,490 @@
+#include <flecs_game_core.h>
+
+ECS_COMPONENT_DECLARE(InterestState);
+
+/* Entities an observer knows about, and the sets produced for the last frame */
+typedef struct InterestState {
+    ecs_map_t known;       /* map<entity, cell the entity was seen in> */
+    ecs_vec_t enter;       /* vector<ecs_entity_t> */
+    ecs_vec_t leave;       /* vector<ecs_entity_t> */
+    ecs_vec_t update;      /* vector<ecs_entity_t> */
+    int32_t x_min;         /* Cells covered by the area in the last frame */
+    int32_t y_min;
+    int32_t x_max;
+    int32_t y_max;
+    bool covered;          /* Whether the area covered cells before */
+} InterestState;
+
+/* Member table that changed this frame */
+typedef struct {
+    ecs_entity_t cell;
+    int32_t x;
+    int32_t y;
+    int32_t offset;        /* Index of first entity in ctx->entities */
+    int32_t count;
+} flecs_game_interest_table_t;
+
+/* Cell that lost members this frame */
+typedef struct {
+    int32_t x;
+    int32_t y;
+} flecs_game_interest_cell_t;
+
+typedef struct {
+    ecs_query_t *changed;  /* Tracked entities, used to find changed tables */
+    ecs_vec_t tables;      /* vector<flecs_game_interest_table_t> */
+    ecs_vec_t entities;    /* vector<ecs_entity_t> of changed tables */
+    ecs_map_t removed;     /* set<cell> of cells that lost members */
+    ecs_vec_t cells;       /* vector<flecs_game_interest_cell_t> */
+} flecs_game_interest_ctx_t;
+
+static
+void flecs_game_interest_fini(
+    InterestState *ptr)
+{
+    if (ecs_map_is_init(&ptr->known)) {
+        ecs_map_fini(&ptr->known);
+    }
+    ecs_vec_fini_t(NULL, &ptr->enter, ecs_entity_t);
+    ecs_vec_fini_t(NULL, &ptr->leave, ecs_entity_t);
+    ecs_vec_fini_t(NULL, &ptr->update, ecs_entity_t);
+}
+
+static ECS_DTOR(InterestState, ptr, {
+    flecs_game_interest_fini(ptr);
+})
+
+static ECS_MOVE(InterestState, dst, src, {
+    flecs_game_interest_fini(dst);
+    *dst = *src;
+    ecs_os_zeromem(src);
+})
+
+static
+void flecs_game_interest_ctx_free(
+    void *ptr)
+{
+    flecs_game_interest_ctx_t *ctx = ptr;
+    ecs_vec_fini_t(NULL, &ctx->tables, flecs_game_interest_table_t);
+    ecs_vec_fini_t(NULL, &ctx->entities, ecs_entity_t);
+    ecs_map_fini(&ctx->removed);
+    ecs_vec_fini_t(NULL, &ctx->cells, flecs_game_interest_cell_t);
+    ecs_os_free(ctx);
+}
+
+static
+bool flecs_game_interest_covers(
+    const InterestState *state,
+    int32_t x,
+    int32_t y)
+{
+    return x >= state->x_min && x <= state->x_max &&
+        y >= state->y_min && y <= state->y_max;
+}
+
+static
+void flecs_game_interest_leave(
+    InterestState *state,
+    ecs_entity_t e)
+{
+    ecs_vec_append_t(NULL, &state->leave, ecs_entity_t)[0] = e;
+    ecs_map_remove(&state->known, e);
+}
+
+/* Members of a cell that entered the area */
+static
+void flecs_game_interest_cell_enter(
+    ecs_world_t *world,
+    InterestState *state,
+    ecs_entity_t cell)
+{
+    ecs_iter_t it = ecs_term_iter(world, &(ecs_term_t){
+        .id = ecs_pair(EcsWorldCell, cell)
+    });
+
+    while (ecs_term_next(&it)) {
+        for (int i = 0; i < it.count; i ++) {
+            ecs_entity_t e = it.entities[i];
+            ecs_map_val_t *known = ecs_map_ensure(&state->known, e);
+            if (!known[0]) {
+                ecs_vec_append_t(NULL, &state->enter, ecs_entity_t)[0] = e;
+            }
+            known[0] = cell;
+        }
+    }
+}
+
+/* Members of a cell that left the area */
+static
+void flecs_game_interest_cell_leave(
+    ecs_world_t *world,
+    InterestState *state,
+    ecs_entity_t cell)
+{
+    ecs_iter_t it = ecs_term_iter(world, &(ecs_term_t){
+        .id = ecs_pair(EcsWorldCell, cell)
+    });
+
+    while (ecs_term_next(&it)) {
+        for (int i = 0; i < it.count; i ++) {
+            ecs_entity_t e = it.entities[i];
+            ecs_map_val_t *known = ecs_map_get(&state->known, e);
+            if (known && known[0] == cell) {
+                flecs_game_interest_leave(state, e);
+            }
+        }
+    }
+}
+
+/* Members of changed tables in cells covered by the area entered the area, or
+ * were updated. */
+static
+void flecs_game_interest_tables(
+    flecs_game_interest_ctx_t *ctx,
+    InterestState *state)
+{
+    const flecs_game_interest_table_t *tables = ecs_vec_first_t(
+        &ctx->tables, flecs_game_interest_table_t);
+    const ecs_entity_t *entities = ecs_vec_first_t(
+        &ctx->entities, ecs_entity_t);
+    int32_t t, count = ecs_vec_count(&ctx->tables);
+
+    for (t = 0; t < count; t ++) {
+        const flecs_game_interest_table_t *table = &tables[t];
+        if (!flecs_game_interest_covers(state, table->x, table->y)) {
+            continue;
+        }
+
+        for (int32_t i = 0; i < table->count; i ++) {
+            ecs_entity_t e = entities[table->offset + i];
+            ecs_map_val_t *known = ecs_map_ensure(&state->known, e);
+            if (!known[0]) {
+                ecs_vec_append_t(NULL, &state->enter, ecs_entity_t)[0] = e;
+            } else {
+                ecs_vec_append_t(NULL, &state->update, ecs_entity_t)[0] = e;
+            }
+            known[0] = table->cell;
+        }
+    }
+}
+
+/* Returns whether a cell that lost members was covered by the area in the
+ * last or in the current frame. */
+static
+bool flecs_game_interest_lost_members(
+    const flecs_game_interest_ctx_t *ctx,
+    const InterestState *prev,
+    const InterestState *state)
+{
+    const flecs_game_interest_cell_t *cells = ecs_vec_first_t(
+        &ctx->cells, flecs_game_interest_cell_t);
+    int32_t i, count = ecs_vec_count(&ctx->cells);
+
+    for (i = 0; i < count; i ++) {
+        int32_t x = cells[i].x, y = cells[i].y;
+        if (flecs_game_interest_covers(state, x, y) ||
+            (prev->covered && flecs_game_interest_covers(prev, x, y)))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Known entities that were deleted, or that moved from the cell they were seen
+ * in to a cell that isn't covered, left the area. Entities that moved to a
+ * covered cell were assigned their new cell by the changed tables. Only runs
+ * when a cell covered by the area lost members. */
+static
+void flecs_game_interest_removed(
+    ecs_world_t *world,
+    flecs_game_interest_ctx_t *ctx,
+    const InterestState *prev,
+    InterestState *state)
+{
+    if (!flecs_game_interest_lost_members(ctx, prev, state)) {
+        return;
+    }
+
+    int32_t i, first = ecs_vec_count(&state->leave);
+    ecs_map_iter_t mit = ecs_map_iter(&state->known);
+    while (ecs_map_next(&mit)) {
+        ecs_entity_t cell = ecs_map_value(&mit);
+        if (!ecs_map_get(&ctx->removed, cell)) {
+            continue;
+        }
+
+        ecs_entity_t e = ecs_map_key(&mit);
+        if (ecs_is_alive(world, e) &&
+            ecs_has_pair(world, e, EcsWorldCell, cell))
+        {
+            continue;
+        }
+
+        ecs_vec_append_t(NULL, &state->leave, ecs_entity_t)[0] = e;
+    }
+
+    /* Remove after iterating, as removing invalidates the map iterator */
+    const ecs_entity_t *leave = ecs_vec_first_t(&state->leave, ecs_entity_t);
+    for (i = first; i < ecs_vec_count(&state->leave); i ++) {
+        ecs_map_remove(&state->known, leave[i]);
+    }
+}
+
+/* Resolve the coordinates of the cells that lost members once per frame */
+static
+void flecs_game_interest_cells(
+    ecs_world_t *world,
+    flecs_game_interest_ctx_t *ctx)
+{
+    ecs_vec_clear(&ctx->cells);
+
+    ecs_map_iter_t mit = ecs_map_iter(&ctx->removed);
+    while (ecs_map_next(&mit)) {
+        ecs_entity_t cell = ecs_map_key(&mit);
+        const EcsWorldCellCoord *coord = ecs_get(
+            world, cell, EcsWorldCellCoord);
+        if (!coord) {
+            continue;
+        }
+
+        flecs_game_interest_cell_t *elem = ecs_vec_append_t(
+            NULL, &ctx->cells, flecs_game_interest_cell_t);
+        elem->x = ecs_world_cell_index(coord->x);
+        elem->y = ecs_world_cell_index(coord->y);
+    }
+}
+
+/* Collect the member tables that changed since the last frame once for all
+ * observers. Visits tables, and only the entities of changed tables. */
+static
+void flecs_game_interest_changed(
+    ecs_world_t *world,
+    flecs_game_interest_ctx_t *ctx)
+{
+    ecs_vec_clear(&ctx->tables);
+    ecs_vec_clear(&ctx->entities);
+
+    if (!ecs_query_changed(ctx->changed, NULL)) {
+        return;
+    }
+
+    ecs_iter_t it = ecs_query_iter(world, ctx->changed);
+    while (ecs_query_next_table(&it)) {
+        if (!ecs_query_changed(NULL, &it)) {
+            continue;
+        }
+
+        /* Populating syncs the change state of the table with the query */
+        ecs_query_populate(&it, false);
+
+        ecs_entity_t cell = ecs_pair_second(world, ecs_field_id(&it, 2));
+        const EcsWorldCellCoord *coord = ecs_get(
+            world, cell, EcsWorldCellCoord);
+        if (!coord) {
+            continue;
+        }
+
+        flecs_game_interest_table_t *table = ecs_vec_append_t(
+            NULL, &ctx->tables, flecs_game_interest_table_t);
+        table->cell = cell;
+        table->x = ecs_world_cell_index(coord->x);
+        table->y = ecs_world_cell_index(coord->y);
+        table->offset = ecs_vec_count(&ctx->entities);
+        table->count = it.count;
+        ecs_os_memcpy_n(ecs_vec_grow_t(NULL, &ctx->entities, ecs_entity_t,
+            it.count), it.entities, ecs_entity_t, it.count);
+    }
+}
+
+/* Only the cell is stored, entities that left it are found through the
+ * entities observers know about. Not tracked when there are no observers. */
+static
+void InterestMemberRemove(ecs_iter_t *it) {
+    flecs_game_interest_ctx_t *ctx = it->ctx;
+    if (!ecs_count_id(it->real_world, ecs_id(EcsInterestArea))) {
+        return;
+    }
+
+    ecs_entity_t cell = ecs_pair_second(it->world, ecs_field_id(it, 1));
+    ecs_map_ensure(&ctx->removed, cell);
+}
+
+static
+void UpdateInterest(ecs_iter_t *it) {
+    ecs_world_t *world = it->world;
+    flecs_game_interest_ctx_t *ctx = it->ctx;
+
+    flecs_game_interest_changed(world, ctx);
+    flecs_game_interest_cells(world, ctx);
+
+    while (ecs_query_next_table(it)) {
+        ecs_query_populate(it, false);
+
+        EcsPosition3 *p = ecs_field(it, EcsPosition3, 1);
+        EcsInterestArea *area = ecs_field(it, EcsInterestArea, 2);
+        InterestState *state = ecs_field(it, InterestState, 3);
+
+        for (int i = 0; i < it->count; i ++) {
+            InterestState *cur = &state[i];
+            float radius = area[i].radius;
+
+            if (!ecs_map_is_init(&cur->known)) {
+                ecs_map_init(&cur->known, NULL);
+            }
+
+            ecs_vec_clear(&cur->enter);
+            ecs_vec_clear(&cur->leave);
+            ecs_vec_clear(&cur->update);
+
+            InterestState prev = *cur;
+            cur->x_min = ecs_world_cell_index(p[i].x - radius);
+            cur->x_max = ecs_world_cell_index(p[i].x + radius);
+            cur->y_min = ecs_world_cell_index(p[i].z - radius);
+            cur->y_max = ecs_world_cell_index(p[i].z + radius);
+            cur->covered = true;
+
+            flecs_game_interest_tables(ctx, cur);
+            flecs_game_interest_removed(world, ctx, &prev, cur);
+
+            /* Cells that left the area */
+            if (prev.covered) {
+                for (int32_t x = prev.x_min; x <= prev.x_max; x ++) {
+                    for (int32_t y = prev.y_min; y <= prev.y_max; y ++) {
+                        if (flecs_game_interest_covers(cur, x, y)) {
+                            continue;
+                        }
+                        ecs_entity_t cell = ecs_world_cell_get(world, x, y);
+                        if (cell) {
+                            flecs_game_interest_cell_leave(world, cur, cell);
+                        }
+                    }
+                }
+            }
+
+            /* Cells that entered the area */
+            for (int32_t x = cur->x_min; x <= cur->x_max; x ++) {
+                for (int32_t y = cur->y_min; y <= cur->y_max; y ++) {
+                    if (prev.covered && flecs_game_interest_covers(&prev, x, y)) {
+                        continue;
+                    }
+                    ecs_entity_t cell = ecs_world_cell_get(world, x, y);
+                    if (cell) {
+                        flecs_game_interest_cell_enter(world, cur, cell);
+                    }
+                }
+            }
+        }
+    }
+
+    ecs_map_clear(&ctx->removed);
+}
+
+static
+const ecs_entity_t* flecs_game_interest_get(
+    const ecs_world_t *world,
+    ecs_entity_t observer,
+    size_t offset,
+    int32_t *count_out)
+{
+    *count_out = 0;
+
+    const InterestState *state = ecs_get(world, observer, InterestState);
+    if (!state) {
+        return NULL;
+    }
+
+    const ecs_vec_t *v = ECS_OFFSET(state, offset);
+    *count_out = ecs_vec_count(v);
+    return ecs_vec_first_t(v, ecs_entity_t);
+}
+
+const ecs_entity_t* ecs_interest_enter(
+    const ecs_world_t *world,
+    ecs_entity_t observer,
+    int32_t *count_out)
+{
+    return flecs_game_interest_get(world, observer,
+        offsetof(InterestState, enter), count_out);
+}
+
+const ecs_entity_t* ecs_interest_leave(
+    const ecs_world_t *world,
+    ecs_entity_t observer,
+    int32_t *count_out)
+{
+    return flecs_game_interest_get(world, observer,
+        offsetof(InterestState, leave), count_out);
+}
+
+const ecs_entity_t* ecs_interest_update(
+    const ecs_world_t *world,
+    ecs_entity_t observer,
+    int32_t *count_out)
+{
+    return flecs_game_interest_get(world, observer,
+        offsetof(InterestState, update), count_out);
+}
+
+void FlecsGameInterestImport(ecs_world_t *world) {
+    ECS_COMPONENT_DEFINE(world, InterestState);
+
+    ecs_set_hooks(world, InterestState, {
+        .ctor = ecs_default_ctor,
+        .dtor = ecs_dtor(InterestState),
+        .move = ecs_move(InterestState)
+    });
+
+    ecs_set_hooks(world, EcsInterestArea, {
+        .ctor = ecs_default_ctor
+    });
+
+    ecs_add_pair(world, ecs_id(EcsInterestArea), EcsWith,
+        ecs_id(InterestState));
+
+    flecs_game_interest_ctx_t *ctx = ecs_os_calloc_t(flecs_game_interest_ctx_t);
+    ecs_map_init(&ctx->removed, NULL);
+    ctx->changed = ecs_query(world, {
+        .filter.terms = {
+            { .id = ecs_id(EcsPosition3), .inout = EcsIn },
+            { .id = ecs_pair(EcsWorldCell, EcsWildcard), .inout = EcsInOutNone }
+        }
+    });
+
+    /* Collects cells that lost members, as entities that left a cell can't be
+     * found through the tables of the cell. Owns the context, as it runs during
+     * world cleanup after the system is deleted. */
+    ecs_observer(world, {
+        .filter.terms = {{ .id = ecs_pair(EcsWorldCell, EcsWildcard) }},
+        .events = { EcsOnRemove },
+        .callback = InterestMemberRemove,
+        .ctx = ctx,
+        .ctx_free = flecs_game_interest_ctx_free
+    });
+
+    /* Reads the cell membership written by UpdateWorldCell, so that the
+     * pipeline merges it before this system runs. */
+    ecs_system(world, {
+        .entity = ecs_entity(world, {
+            .name = "UpdateInterest",
+            .add = { ecs_dependson(EcsPostUpdate) }
+        }),
+        .query.filter.terms = {{
+            .id = ecs_id(EcsPosition3),
+            .inout = EcsIn
+        }, {
+            .id = ecs_id(EcsInterestArea),
+            .inout = EcsIn
+        }, {
+            .id = ecs_id(InterestState),
+            .inout = EcsInOut
+        }, {
+            .id = ecs_pair(EcsWorldCell, EcsWildcard),
+            .src.flags = EcsIsEntity,
+            .inout = EcsIn
+        }},
+        .run = UpdateInterest,
+        .ctx = ctx
+    });
+}
@@ -0,0 +1,53 @@
+#define FLECS_GAME_CORE_IMPL
+
+#include <flecs_game_core.h>
+
+void FlecsGameWorldCellsImport(ecs_world_t *world);
+void FlecsGameTimeOfDayImport(ecs_world_t *world);
+void FlecsGameGridImport(ecs_world_t *world);
+void FlecsGameSnapshotImport(ecs_world_t *world);
+void FlecsGameFlowFieldImport(ecs_world_t *world);
+void FlecsGameInterestImport(ecs_world_t *world);
+void FlecsGameWorldCellSortImport(ecs_world_t *world);
+
+void FlecsGameCoreImport(ecs_world_t *world) {
+    ECS_MODULE(world, FlecsGameCore);
+
+    ECS_IMPORT(world, FlecsComponentsTransform);
+    ECS_IMPORT(world, FlecsComponentsPhysics);
+    ECS_IMPORT(world, FlecsSystemsPhysics);
+
+    /* Core components are created in the flecs.game scope, so that their paths
+     * don't depend on whether the core or the full module is imported. */
+    ecs_set_scope(world, ecs_get_parent(world, ecs_id(FlecsGameCore)));
+    ecs_set_name_prefix(world, "Ecs");
+
+    ECS_META_COMPONENT(world, EcsWorldCellCoord);
+    ECS_META_COMPONENT(world, EcsTimeOfDay);
+    ECS_META_COMPONENT(world, ecs_time_of_day_color_t);
+    ECS_META_COMPONENT(world, ecs_time_of_day_key_t);
+    ECS_META_COMPONENT(world, EcsTimeOfDayCurve);
+    ECS_META_COMPONENT(world, ecs_grid_slot_t);
+    ECS_META_COMPONENT(world, ecs_grid_coord_t);
+    ECS_META_COMPONENT(world, EcsGrid);
+    ECS_META_COMPONENT(world, EcsGridAsync);
+    ECS_META_COMPONENT(world, EcsNavObstacle);
+    ECS_META_COMPONENT(world, EcsFlowField);
+    ECS_META_COMPONENT(world, EcsInterestArea);
+    ECS_META_COMPONENT(world, EcsWorldCellSort);
+    ECS_META_COMPONENT(world, EcsGameStats);
+
+    ecs_set_hooks(world, EcsGameStats, {
+        .ctor = ecs_default_ctor
+    });
+
+    ecs_singleton_set(world, EcsGameStats, {0});
+
+    FlecsGameTimeOfDayImport(world);
+    FlecsGameWorldCellsImport(world);
+    FlecsGameGridImport(world);
+    FlecsGameSnapshotImport(world);
+    FlecsGameFlowFieldImport(world);
+    FlecsGameInterestImport(world);
+    FlecsGameWorldCellSortImport(world);
+}
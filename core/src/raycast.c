@@ -0,0 +1,123 @@
+#include <flecs_game_core.h>
+#include <float.h>
+
+/* Distance along the ray to the next cell bound on an axis. Bounds come from
+ * ecs_world_cell_lower, so they match the cells of ecs_world_cell_index. */
+static
+float flecs_game_ray_next(
+    int32_t index,
+    float origin,
+    float dir)
+{
+    if (dir > 0) {
+        return (ecs_world_cell_lower(index + 1) - origin) / dir;
+    } else if (dir < 0) {
+        return (ecs_world_cell_lower(index) - origin) / dir;
+    }
+    return FLT_MAX;
+}
+
+/* Test members of a cell. Returns whether a hit closer than hit_out was found */
+static
+bool flecs_game_ray_test_cell(
+    const ecs_world_t *world,
+    ecs_entity_t cell,
+    const ecs_world_cell_ray_t *ray,
+    ecs_world_cell_ray_hit_t *hit_out)
+{
+    bool result = false;
+    ecs_iter_t it = ecs_term_iter(world, &(ecs_term_t){
+        .id = ecs_pair(EcsWorldCell, cell)
+    });
+
+    while (ecs_term_next(&it)) {
+        float distance = hit_out->distance;
+        int32_t row = ray->test(&it, ray, &distance);
+        if (row != -1 && distance < hit_out->distance) {
+            hit_out->entity = it.entities[row];
+            hit_out->distance = distance;
+            result = true;
+            if (ray->any) {
+                ecs_iter_fini(&it);
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+bool ecs_world_cell_raycast(
+    const ecs_world_t *world,
+    const ecs_world_cell_ray_t *ray,
+    ecs_world_cell_ray_hit_t *hit_out)
+{
+    ecs_assert(ray != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(ray->test != NULL, ECS_INVALID_PARAMETER, NULL);
+    ecs_assert(hit_out != NULL, ECS_INVALID_PARAMETER, NULL);
+
+    hit_out->entity = 0;
+    hit_out->distance = ray->max_distance;
+
+    float ox = ray->origin.x, oz = ray->origin.z;
+    float dx = ray->direction.x, dz = ray->direction.z;
+    int32_t x = ecs_world_cell_index(ox);
+    int32_t y = ecs_world_cell_index(oz);
+    int32_t step_x = dx > 0 ? 1 : -1;
+    int32_t step_y = dz > 0 ? 1 : -1;
+    float t = 0;
+
+    /* Visit cells in order of distance. Members are found through the cell
+     * that contains their position, so the walk continues until a cell starts
+     * beyond the closest hit, as a member of a later cell can be closer. */
+    while (t <= hit_out->distance) {
+        ecs_entity_t cell = ecs_world_cell_get(world, x, y);
+        if (cell) {
+            if (flecs_game_ray_test_cell(world, cell, ray, hit_out)) {
+                if (ray->any) {
+                    return true;
+                }
+            }
+        }
+
+        float tx = flecs_game_ray_next(x, ox, dx);
+        float tz = flecs_game_ray_next(y, oz, dz);
+        if (tx < tz) {
+            t = tx;
+            x += step_x;
+        } else if (tz != FLT_MAX) {
+            t = tz;
+            y += step_y;
+        } else {
+            break; /* Ray is parallel to the y axis */
+        }
+    }
+
+    return hit_out->entity != 0;
+}
+
+bool ecs_world_cell_line_of_sight(
+    const ecs_world_t *world,
+    const EcsPosition3 *from,
+    const EcsPosition3 *to,
+    ecs_world_cell_ray_test_t test,
+    void *ctx)
+{
+    float dx = to->x - from->x, dy = to->y - from->y, dz = to->z - from->z;
+    float length = sqrt(dx * dx + dy * dy + dz * dz);
+    if (length == 0) {
+        return true;
+    }
+
+    ecs_world_cell_ray_t ray = {
+        .origin = *from,
+        .direction = { dx / length, dy / length, dz / length },
+        .max_distance = length,
+        .test = test,
+        .ctx = ctx,
+        .any = true
+    };
+
+    ecs_world_cell_ray_hit_t hit;
+    return !ecs_world_cell_raycast(world, &ray, &hit);
+}
@@ -0,0 +1,829 @@
+#include <flecs_game_core.h>
+#include <stdio.h>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define SNAPSHOT_MAGIC (0x53534746) /* "FGSS" */
+#define SNAPSHOT_VERSION (2)
+#define SNAPSHOT_ALIGN (8)
+#define SNAPSHOT_PREFABS (21) /* prefab + variations */
+
+ECS_COMPONENT_DECLARE(GridRestored);
+
+ecs_entity_t flecs_game_grid_get_prefab(
+    ecs_world_t *world,
+    ecs_entity_t parent,
+    ecs_entity_t prefab);
+
+void flecs_game_world_cell_register(
+    ecs_world_t *world,
+    int32_t x,
+    int32_t y,
+    ecs_entity_t cell);
+
+/* Grid parameters of a grid that was restored from a snapshot. Prevents the
+ * grid from being regenerated when it is set to the same value. */
+typedef struct GridRestored {
+    EcsGrid grid;
+} GridRestored;
+
+/* File layout. All sections start at a multiple of SNAPSHOT_ALIGN, so that
+ * component arrays can be passed directly from a memory mapped file.
+ *
+ * header
+ * EcsWorldCellCoord[cell_count]
+ * grid record[grid_count], where a record is:
+ *   ecs_game_snapshot_grid_t
+ *   grid path, prefab paths (zero terminated)
+ *   group[group_count], where a group is:
+ *     ecs_game_snapshot_group_t (tiles of one prefab in one world cell)
+ *     EcsPosition3[count]
+ *     EcsRotation3[count] (if rotated)
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    int32_t cell_shift;
+    int32_t grid_count;
+    int64_t cell_count;
+    int64_t cells_offset;
+    int64_t grids_offset;
+} ecs_game_snapshot_header_t;
+
+typedef struct {
+    uint32_t size;
+    int32_t group_count;
+    uint32_t path_len;
+    uint32_t prefab_path_len[SNAPSHOT_PREFABS];
+    EcsGrid grid;
+} ecs_game_snapshot_grid_t;
+
+typedef struct {
+    int32_t slot; /* -1 for grid prefab, variation index otherwise */
+    int32_t rotated;
+    int32_t count;
+    int32_t reserved;
+    int32_t cell_x; /* Signed index of the world cell of the tiles */
+    int32_t cell_y;
+} ecs_game_snapshot_group_t;
+
+typedef struct {
+    int32_t x;
+    int32_t y;
+    int32_t row;
+} snapshot_tile_cell_t;
+
+/* Tiles of a grid, grouped for writing */
+typedef struct {
+    ecs_vec_t groups;      /* vector<ecs_game_snapshot_group_t> */
+    ecs_vec_t positions;   /* vector<EcsPosition3> */
+    ecs_vec_t rotations;   /* vector<EcsRotation3> */
+    uint32_t size;         /* Size of the groups in the file */
+} snapshot_grid_tiles_t;
+
+typedef struct {
+    const uint8_t *ptr;
+    const uint8_t *end;
+} snapshot_reader_t;
+
+static
+size_t snapshot_align(
+    size_t size)
+{
+    return (size + SNAPSHOT_ALIGN - 1) & ~(size_t)(SNAPSHOT_ALIGN - 1);
+}
+
+static
+int snapshot_write(
+    FILE *f,
+    const void *ptr,
+    size_t size)
+{
+    static const uint8_t zero[SNAPSHOT_ALIGN] = {0};
+    size_t padding = snapshot_align(size) - size;
+    if (size && fwrite(ptr, size, 1, f) != 1) {
+        return -1;
+    }
+    if (padding && fwrite(zero, padding, 1, f) != 1) {
+        return -1;
+    }
+    return 0;
+}
+
+static
+const void* snapshot_read(
+    snapshot_reader_t *r,
+    size_t size)
+{
+    size_t aligned = snapshot_align(size);
+    if ((size_t)(r->end - r->ptr) < aligned) {
+        return NULL;
+    }
+    const void *result = r->ptr;
+    r->ptr += aligned;
+    return result;
+}
+
+static
+bool flecs_game_grid_coord_equal(
+    const ecs_grid_coord_t *a,
+    const ecs_grid_coord_t *b)
+{
+    return a->count == b->count && a->spacing == b->spacing &&
+        a->variation == b->variation;
+}
+
+static
+bool flecs_game_grid_equal(
+    const EcsGrid *a,
+    const EcsGrid *b)
+{
+    if (!flecs_game_grid_coord_equal(&a->x, &b->x) ||
+        !flecs_game_grid_coord_equal(&a->y, &b->y) ||
+        !flecs_game_grid_coord_equal(&a->z, &b->z))
+    {
+        return false;
+    }
+
+    if (a->border.x != b->border.x || a->border.y != b->border.y ||
+        a->border.z != b->border.z ||
+        a->border_offset.x != b->border_offset.x ||
+        a->border_offset.y != b->border_offset.y ||
+        a->border_offset.z != b->border_offset.z)
+    {
+        return false;
+    }
+
+    if (a->prefab != b->prefab) {
+        return false;
+    }
+
+    for (int i = 0; i < SNAPSHOT_PREFABS - 1; i ++) {
+        if (a->variations[i].prefab != b->variations[i].prefab ||
+            a->variations[i].chance != b->variations[i].chance)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool flecs_game_grid_is_restored(
+    ecs_world_t *world,
+    ecs_entity_t grid,
+    const EcsGrid *value)
+{
+    const GridRestored *restored = ecs_get(world, grid, GridRestored);
+    if (!restored) {
+        return false;
+    }
+
+    if (flecs_game_grid_equal(&restored->grid, value)) {
+        return true;
+    }
+
+    ecs_remove(world, grid, GridRestored);
+    return false;
+}
+
+static
+ecs_entity_t* snapshot_grid_prefab_ptr(
+    EcsGrid *grid,
+    int32_t index)
+{
+    if (!index) {
+        return &grid->prefab;
+    }
+    return &grid->variations[index - 1].prefab;
+}
+
+/* Find the slot that a tile prefab was created for */
+static
+int32_t snapshot_grid_slot(
+    const ecs_world_t *world,
+    const EcsGrid *grid,
+    ecs_entity_t prefab)
+{
+    if (grid->prefab) {
+        return -1;
+    }
+
+    for (int32_t v = 0; v < SNAPSHOT_PREFABS - 1; v ++) {
+        ecs_entity_t slot = grid->variations[v].prefab;
+        if (!slot) {
+            break;
+        }
+
+        /* Assemblies are instantiated as private prefabs */
+        if (slot == prefab || ecs_has_id(world, prefab, slot)) {
+            return v;
+        }
+    }
+
+    return -2;
+}
+
+/* Add group of tiles. If rows is NULL the first count tiles are added. */
+static
+void snapshot_add_group(
+    snapshot_grid_tiles_t *tiles,
+    int32_t slot,
+    const EcsPosition3 *p,
+    const EcsRotation3 *r,
+    const int32_t *rows,
+    int32_t count,
+    int32_t cell_x,
+    int32_t cell_y)
+{
+    ecs_game_snapshot_group_t *group = ecs_vec_append_t(
+        NULL, &tiles->groups, ecs_game_snapshot_group_t);
+    group->slot = slot;
+    group->rotated = r != NULL;
+    group->count = count;
+    group->reserved = 0;
+    group->cell_x = cell_x;
+    group->cell_y = cell_y;
+
+    tiles->size += sizeof(ecs_game_snapshot_group_t);
+    tiles->size += snapshot_align(count * sizeof(EcsPosition3));
+    EcsPosition3 *p_dst = ecs_vec_grow_t(
+        NULL, &tiles->positions, EcsPosition3, count);
+    EcsRotation3 *r_dst = NULL;
+    if (r) {
+        tiles->size += snapshot_align(count * sizeof(EcsRotation3));
+        r_dst = ecs_vec_grow_t(NULL, &tiles->rotations, EcsRotation3, count);
+    }
+
+    for (int32_t i = 0; i < count; i ++) {
+        int32_t row = rows ? rows[i] : i;
+        p_dst[i] = p[row];
+        if (r) {
+            r_dst[i] = r[row];
+        }
+    }
+}
+
+static
+int snapshot_compare_tile_cell(
+    const void *ptr_1,
+    const void *ptr_2)
+{
+    const snapshot_tile_cell_t *c1 = ptr_1, *c2 = ptr_2;
+    if (c1->x != c2->x) {
+        return c1->x < c2->x ? -1 : 1;
+    }
+    if (c1->y != c2->y) {
+        return c1->y < c2->y ? -1 : 1;
+    }
+    return c1->row - c2->row;
+}
+
+/* Split tiles that are not yet assigned to a world cell by the cell that
+ * contains their position. */
+static
+void snapshot_add_unassigned(
+    snapshot_grid_tiles_t *tiles,
+    int32_t slot,
+    const EcsPosition3 *p,
+    const EcsRotation3 *r,
+    int32_t count)
+{
+    snapshot_tile_cell_t *cells = ecs_os_malloc_n(snapshot_tile_cell_t, count);
+    int32_t *rows = ecs_os_malloc_n(int32_t, count);
+    int32_t i, start = 0;
+
+    for (i = 0; i < count; i ++) {
+        cells[i].x = ecs_world_cell_index(p[i].x);
+        cells[i].y = ecs_world_cell_index(p[i].z);
+        cells[i].row = i;
+    }
+
+    qsort(cells, count, sizeof(snapshot_tile_cell_t), 
+        snapshot_compare_tile_cell);
+
+    for (i = 0; i < count; i ++) {
+        rows[i] = cells[i].row;
+        bool last = (i == count - 1) || 
+            cells[i + 1].x != cells[i].x || cells[i + 1].y != cells[i].y;
+        if (last) {
+            snapshot_add_group(tiles, slot, p, r, &rows[start], 
+                i - start + 1, cells[i].x, cells[i].y);
+            start = i + 1;
+        }
+    }
+
+    ecs_os_free(cells);
+    ecs_os_free(rows);
+}
+
+static
+int snapshot_save_cells(
+    const ecs_world_t *world,
+    FILE *f,
+    int64_t *count_out)
+{
+    ecs_vec_t coords = {0};
+    ecs_iter_t it = ecs_term_iter(world, &(ecs_term_t){
+        .id = ecs_id(EcsWorldCellCoord)
+    });
+
+    while (ecs_term_next(&it)) {
+        EcsWorldCellCoord *coord = ecs_field(&it, EcsWorldCellCoord, 1);
+        for (int i = 0; i < it.count; i ++) {
+            ecs_vec_append_t(NULL, &coords, EcsWorldCellCoord)[0] = coord[i];
+        }
+    }
+
+    int32_t count = ecs_vec_count(&coords);
+    int result = snapshot_write(f, ecs_vec_first(&coords),
+        (size_t)count * sizeof(EcsWorldCellCoord));
+    ecs_vec_fini_t(NULL, &coords, EcsWorldCellCoord);
+
+    *count_out = count;
+    return result;
+}
+
+static
+int snapshot_save_grid(
+    const ecs_world_t *world,
+    FILE *f,
+    ecs_entity_t g,
+    const EcsGrid *grid)
+{
+    char *path = ecs_get_fullpath(world, g);
+    char *prefab_paths[SNAPSHOT_PREFABS] = {0};
+    ecs_game_snapshot_grid_t hdr = { .grid = *grid };
+    int result = -1;
+
+    hdr.path_len = (uint32_t)ecs_os_strlen(path) + 1;
+    hdr.size = sizeof(hdr) + snapshot_align(hdr.path_len);
+
+    for (int32_t i = 0; i < SNAPSHOT_PREFABS; i ++) {
+        ecs_entity_t *prefab = snapshot_grid_prefab_ptr(&hdr.grid, i);
+        if (*prefab) {
+            prefab_paths[i] = ecs_get_fullpath(world, *prefab);
+            hdr.prefab_path_len[i] =
+                (uint32_t)ecs_os_strlen(prefab_paths[i]) + 1;
+            hdr.size += snapshot_align(hdr.prefab_path_len[i]);
+            *prefab = 0;
+        }
+    }
+
+    /* Tiles are grouped by prefab, world cell and by whether they have a
+     * rotation. This lets restore create each group with a single bulk
+     * operation, in the table it ends up in after cell assignment. */
+    snapshot_grid_tiles_t tiles = {0};
+    ecs_filter_t *flt = ecs_filter((ecs_world_t*)world, {
+        .terms = {
+            { .id = ecs_pair(EcsChildOf, g) },
+            { .id = ecs_id(EcsPosition3), .inout = EcsIn },
+            { .id = ecs_id(EcsRotation3), .inout = EcsIn, .oper = EcsOptional },
+            { .id = ecs_pair(EcsIsA, EcsWildcard), .inout = EcsInOutNone },
+            { .id = ecs_pair(EcsWorldCell, EcsWildcard), .inout = EcsInOutNone,
+              .oper = EcsOptional }
+        }
+    });
+
+    ecs_iter_t it = ecs_filter_iter(world, flt);
+    while (ecs_filter_next(&it)) {
+        EcsPosition3 *p = ecs_field(&it, EcsPosition3, 2);
+        EcsRotation3 *r = NULL;
+        if (ecs_field_is_set(&it, 3)) {
+            r = ecs_field(&it, EcsRotation3, 3);
+        }
+
+        ecs_entity_t prefab = ecs_pair_second(world, ecs_field_id(&it, 4));
+        int32_t slot = snapshot_grid_slot(world, grid, prefab);
+        if (slot == -2) {
+            continue; /* Not a tile */
+        }
+
+        const EcsWorldCellCoord *coord = NULL;
+        if (ecs_field_is_set(&it, 5)) {
+            coord = ecs_get(world, ecs_pair_second(world, 
+                ecs_field_id(&it, 5)), EcsWorldCellCoord);
+        }
+
+        if (coord) {
+            snapshot_add_group(&tiles, slot, p, r, NULL, it.count,
+                ecs_world_cell_index(coord->x), ecs_world_cell_index(coord->y));
+        } else {
+            snapshot_add_unassigned(&tiles, slot, p, r, it.count);
+        }
+    }
+
+    ecs_filter_fini(flt);
+
+    hdr.size += tiles.size;
+    hdr.group_count = ecs_vec_count(&tiles.groups);
+    if (snapshot_write(f, &hdr, sizeof(hdr))) {
+        goto error;
+    }
+    if (snapshot_write(f, path, hdr.path_len)) {
+        goto error;
+    }
+    for (int32_t i = 0; i < SNAPSHOT_PREFABS; i ++) {
+        if (prefab_paths[i]) {
+            if (snapshot_write(f, prefab_paths[i], hdr.prefab_path_len[i])) {
+                goto error;
+            }
+        }
+    }
+
+    EcsPosition3 *p = ecs_vec_first_t(&tiles.positions, EcsPosition3);
+    EcsRotation3 *r = ecs_vec_first_t(&tiles.rotations, EcsRotation3);
+    ecs_game_snapshot_group_t *group = ecs_vec_first_t(
+        &tiles.groups, ecs_game_snapshot_group_t);
+    for (int32_t i = 0; i < hdr.group_count; i ++) {
+        int32_t count = group[i].count;
+        if (snapshot_write(f, &group[i], sizeof(ecs_game_snapshot_group_t))) {
+            goto error;
+        }
+        if (snapshot_write(f, p, count * sizeof(EcsPosition3))) {
+            goto error;
+        }
+        p += count;
+        if (group[i].rotated) {
+            if (snapshot_write(f, r, count * sizeof(EcsRotation3))) {
+                goto error;
+            }
+            r += count;
+        }
+    }
+
+    result = 0;
+error:
+    for (int32_t i = 0; i < SNAPSHOT_PREFABS; i ++) {
+        ecs_os_free(prefab_paths[i]);
+    }
+    ecs_vec_fini_t(NULL, &tiles.groups, ecs_game_snapshot_group_t);
+    ecs_vec_fini_t(NULL, &tiles.positions, EcsPosition3);
+    ecs_vec_fini_t(NULL, &tiles.rotations, EcsRotation3);
+    ecs_os_free(path);
+    return result;
+}
+
+static
+int snapshot_save_grids(
+    const ecs_world_t *world,
+    FILE *f,
+    int32_t *count_out)
+{
+    int32_t count = 0;
+    ecs_iter_t it = ecs_term_iter(world, &(ecs_term_t){
+        .id = ecs_id(EcsGrid)
+    });
+
+    while (ecs_term_next(&it)) {
+        EcsGrid *grid = ecs_field(&it, EcsGrid, 1);
+        for (int i = 0; i < it.count; i ++) {
+            if (!ecs_get_name(world, it.entities[i])) {
+                ecs_warn("snapshot: skipping grid without name");
+                continue;
+            }
+            if (snapshot_save_grid(world, f, it.entities[i], &grid[i])) {
+                ecs_iter_fini(&it);
+                return -1;
+            }
+            count ++;
+        }
+    }
+
+    *count_out = count;
+    return 0;
+}
+
+int ecs_game_snapshot_save(
+    const ecs_world_t *world,
+    const char *filename)
+{
+    FILE *f = fopen(filename, "wb");
+    if (!f) {
+        ecs_err("snapshot: failed to open '%s' for writing", filename);
+        return -1;
+    }
+
+    ecs_game_snapshot_header_t hdr = {
+        .magic = SNAPSHOT_MAGIC,
+        .version = SNAPSHOT_VERSION,
+        .cell_shift = FLECS_GAME_WORLD_CELL_SHIFT
+    };
+
+    /* Write header twice, the second time with the section offsets */
+    if (snapshot_write(f, &hdr, sizeof(hdr))) {
+        goto error;
+    }
+
+    hdr.cells_offset = ftell(f);
+    if (snapshot_save_cells(world, f, &hdr.cell_count)) {
+        goto error;
+    }
+
+    hdr.grids_offset = ftell(f);
+    if (snapshot_save_grids(world, f, &hdr.grid_count)) {
+        goto error;
+    }
+
+    if (fseek(f, 0, SEEK_SET) || snapshot_write(f, &hdr, sizeof(hdr))) {
+        goto error;
+    }
+
+    fclose(f);
+    return 0;
+error:
+    ecs_err("snapshot: failed to write '%s'", filename);
+    fclose(f);
+    return -1;
+}
+
+static
+void snapshot_restore_cells(
+    ecs_world_t *world,
+    const EcsWorldCellCoord *coords,
+    int32_t count)
+{
+    /* Only create cells that don't exist yet */
+    EcsWorldCellCoord *missing = NULL;
+    int32_t i, missing_count = 0;
+    for (i = 0; i < count; i ++) {
+        const EcsWorldCellCoord *c = &coords[i];
+        if (ecs_world_cell_get(world, ecs_world_cell_index(c->x),
+            ecs_world_cell_index(c->y)))
+        {
+            if (!missing) {
+                missing = ecs_os_malloc_n(EcsWorldCellCoord, count);
+                ecs_os_memcpy_n(missing, coords, EcsWorldCellCoord, i);
+                missing_count = i;
+            }
+        } else if (missing) {
+            missing[missing_count ++] = *c;
+        }
+    }
+
+    const EcsWorldCellCoord *create = coords;
+    if (missing) {
+        create = missing;
+    } else {
+        missing_count = count;
+    }
+
+    if (missing_count) {
+        const ecs_entity_t *cells = ecs_bulk_init(world, &(ecs_bulk_desc_t){
+            .count = missing_count,
+            .ids = {
+                EcsWorldCell,
+                ecs_pair(EcsChildOf, EcsWorldCellRoot),
+                ecs_id(EcsWorldCellCoord)
+            },
+            .data = (void*[]){ NULL, NULL, (void*)create }
+        });
+
+        for (i = 0; i < missing_count; i ++) {
+            flecs_game_world_cell_register(world,
+                ecs_world_cell_index(create[i].x),
+                ecs_world_cell_index(create[i].y),
+                cells[i]);
+        }
+    }
+
+    ecs_os_free(missing);
+}
+
+static
+int snapshot_restore_grid(
+    ecs_world_t *world,
+    snapshot_reader_t *r)
+{
+    const ecs_game_snapshot_grid_t *hdr = snapshot_read(r, sizeof(*hdr));
+    if (!hdr) {
+        return -1;
+    }
+
+    const uint8_t *record_end = (const uint8_t*)hdr + hdr->size;
+    if (record_end > r->end) {
+        return -1;
+    }
+
+    const char *path = snapshot_read(r, hdr->path_len);
+    if (!path || path[hdr->path_len - 1]) {
+        return -1;
+    }
+
+    EcsGrid grid = hdr->grid;
+    bool resolved = true;
+    for (int32_t i = 0; i < SNAPSHOT_PREFABS; i ++) {
+        if (!hdr->prefab_path_len[i]) {
+            continue;
+        }
+        const char *prefab_path = snapshot_read(r, hdr->prefab_path_len[i]);
+        if (!prefab_path || prefab_path[hdr->prefab_path_len[i] - 1]) {
+            return -1;
+        }
+        ecs_entity_t prefab = ecs_lookup_fullpath(world, prefab_path);
+        if (!prefab) {
+            ecs_warn("snapshot: grid '%s' uses unknown prefab '%s'",
+                path, prefab_path);
+            resolved = false;
+        }
+        *snapshot_grid_prefab_ptr(&grid, i) = prefab;
+    }
+
+    ecs_entity_t g = ecs_lookup_fullpath(world, path);
+    if (!resolved || (g && flecs_game_grid_is_restored(world, g, &grid))) {
+        /* Skip record. If the grid could not be resolved it is generated once
+         * the application sets it. */
+        r->ptr = record_end;
+        return 0;
+    }
+
+    if (!g) {
+        g = ecs_new_from_fullpath(world, path);
+    }
+
+    ecs_delete_with(world, ecs_pair(EcsChildOf, g));
+
+    /* Resolve prefabs the same way as grid generation does */
+    ecs_entity_t slots[SNAPSHOT_PREFABS - 1] = {0}, prefab = 0;
+    ecs_entity_t old_scope = ecs_set_scope(world, g);
+    if (grid.prefab) {
+        prefab = flecs_game_grid_get_prefab(world, g, grid.prefab);
+    } else {
+        for (int32_t v = 0; v < SNAPSHOT_PREFABS - 1; v ++) {
+            if (!grid.variations[v].prefab) {
+                break;
+            }
+            slots[v] = flecs_game_grid_get_prefab(world, g,
+                grid.variations[v].prefab);
+        }
+    }
+    ecs_set_scope(world, old_scope);
+
+    for (int32_t i = 0; i < hdr->group_count; i ++) {
+        const ecs_game_snapshot_group_t *group = snapshot_read(
+            r, sizeof(ecs_game_snapshot_group_t));
+        if (!group) {
+            return -1;
+        }
+
+        const EcsPosition3 *p = snapshot_read(
+            r, group->count * sizeof(EcsPosition3));
+        const EcsRotation3 *rot = NULL;
+        if (!p) {
+            return -1;
+        }
+        if (group->rotated) {
+            rot = snapshot_read(r, group->count * sizeof(EcsRotation3));
+            if (!rot) {
+                return -1;
+            }
+        }
+
+        ecs_entity_t slot = prefab;
+        if (group->slot >= 0 && group->slot < SNAPSHOT_PREFABS - 1) {
+            slot = slots[group->slot];
+        }
+        if (!slot) {
+            continue;
+        }
+
+        /* Tiles are created with their cell, so that UpdateWorldCell
+         * doesn't have to move them one by one. */
+        ecs_bulk_desc_t desc = { .count = group->count };
+        void *data[5] = {0};
+        int32_t id_count = 0;
+        desc.ids[id_count ++] = ecs_pair(EcsIsA, slot);
+        desc.ids[id_count ++] = ecs_pair(EcsChildOf, g);
+        data[id_count] = (void*)p;
+        desc.ids[id_count ++] = ecs_id(EcsPosition3);
+        if (rot) {
+            data[id_count] = (void*)rot;
+            desc.ids[id_count ++] = ecs_id(EcsRotation3);
+        }
+
+        ecs_entity_t cell = ecs_world_cell_get(
+            world, group->cell_x, group->cell_y);
+        if (cell) {
+            desc.ids[id_count ++] = ecs_pair(EcsWorldCell, cell);
+        }
+
+        desc.data = data;
+        ecs_bulk_init(world, &desc);
+    }
+
+    /* Set restored marker before the grid, so SetGrid doesn't regenerate */
+    ecs_set(world, g, GridRestored, { grid });
+    ecs_set_ptr(world, g, EcsGrid, &grid);
+
+    r->ptr = record_end;
+    return 0;
+}
+
+static
+int snapshot_restore(
+    ecs_world_t *world,
+    const uint8_t *data,
+    size_t size)
+{
+    const ecs_game_snapshot_header_t *hdr = (const void*)data;
+    if (size < sizeof(*hdr) || hdr->magic != SNAPSHOT_MAGIC ||
+        hdr->version != SNAPSHOT_VERSION)
+    {
+        ecs_err("snapshot: invalid file");
+        return -1;
+    }
+
+    if (hdr->cell_shift != FLECS_GAME_WORLD_CELL_SHIFT) {
+        ecs_err("snapshot: world cell size does not match");
+        return -1;
+    }
+
+    snapshot_reader_t r = { data + hdr->cells_offset, data + size };
+    if (hdr->cells_offset > (int64_t)size || hdr->grids_offset > (int64_t)size) {
+        ecs_err("snapshot: file is truncated");
+        return -1;
+    }
+
+    const EcsWorldCellCoord *coords = snapshot_read(
+        &r, hdr->cell_count * sizeof(EcsWorldCellCoord));
+    if (!coords && hdr->cell_count) {
+        ecs_err("snapshot: file is truncated");
+        return -1;
+    }
+
+    snapshot_restore_cells(world, coords, (int32_t)hdr->cell_count);
+
+    r.ptr = data + hdr->grids_offset;
+    for (int32_t i = 0; i < hdr->grid_count; i ++) {
+        if (snapshot_restore_grid(world, &r)) {
+            ecs_err("snapshot: grid data is corrupt");
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int ecs_game_snapshot_restore(
+    ecs_world_t *world,
+    const char *filename)
+{
+    int result = -1;
+
+#ifndef _WIN32
+    int fd = open(filename, O_RDONLY);
+    if (fd == -1) {
+        ecs_err("snapshot: failed to open '%s'", filename);
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) || !st.st_size) {
+        ecs_err("snapshot: failed to read '%s'", filename);
+        close(fd);
+        return -1;
+    }
+
+    void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        ecs_err("snapshot: failed to map '%s'", filename);
+        return -1;
+    }
+
+    result = snapshot_restore(world, data, (size_t)st.st_size);
+    munmap(data, (size_t)st.st_size);
+#else
+    FILE *f = fopen(filename, "rb");
+    if (!f) {
+        ecs_err("snapshot: failed to open '%s'", filename);
+        return -1;
+    }
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    /* Allocate with malloc, which is aligned for any component type */
+    void *data = ecs_os_malloc(size);
+    if (size > 0 && fread(data, (size_t)size, 1, f) == 1) {
+        result = snapshot_restore(world, data, (size_t)size);
+    } else {
+        ecs_err("snapshot: failed to read '%s'", filename);
+    }
+
+    ecs_os_free(data);
+    fclose(f);
+#endif
+
+    return result;
+}
+
+void FlecsGameSnapshotImport(ecs_world_t *world) {
+    ECS_COMPONENT_DEFINE(world, GridRestored);
+}
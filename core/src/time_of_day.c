@@ -0,0 +1,211 @@
+#include <flecs_game_core.h>
+
+#define TOD_LUT_SIZE FLECS_GAME_TIME_OF_DAY_LUT_SIZE
+
+ECS_COMPONENT_DECLARE(EcsTimeOfDayTable);
+
+static
+float get_time_of_day(float t) {
+    return (t + 1.0) * M_PI;
+}
+
+static
+float get_sun_height(float t) {
+    return -sin(get_time_of_day(t));
+}
+
+/* Built-in day cycle, used when no TimeOfDayCurve is set */
+static
+void tod_eval_default(
+    float sun_height,
+    ecs_time_of_day_sample_t *out)
+{
+    static vec3 day = {0.8, 0.8, 0.75};
+    static vec3 twilight = {1.0, 0.1, 0.01};
+    static vec3 ambient_day = {0.03, 0.06, 0.09};
+    static vec3 ambient_night = {0.001, 0.008, 0.016};
+    static vec3 ambient_twilight = {0.01, 0.017, 0.02};
+    float twilight_angle = 0.3;
+    float twilight_zone = 0.2;
+
+    float t_sin_low = twilight_angle - sun_height;
+    if (t_sin_low > 0) {
+        t_sin_low *= 1.0 / twilight_angle;
+        glm_vec3_lerp(day, twilight, t_sin_low, out->sun_color);
+    } else {
+        glm_vec3_copy(day, out->sun_color);
+    }
+
+    /* increase just before sunrise/after sunset*/
+    out->sun_intensity = glm_max(0, sun_height + 0.07);
+
+    float t_sin = (sun_height + 1.0) / 2;
+    float t_twilight = glm_max(0.0, twilight_zone - fabs(t_sin - 0.5));
+    t_twilight *= (1.0 / twilight_zone);
+
+    glm_vec3_lerp(ambient_night, ambient_day, t_sin, out->ambient_color);
+    glm_vec3_lerp(out->ambient_color, ambient_twilight, t_twilight,
+        out->ambient_color);
+}
+
+static
+void tod_key_to_sample(
+    const ecs_time_of_day_key_t *key,
+    ecs_time_of_day_sample_t *out)
+{
+    out->sun_color[0] = key->sun_color.r;
+    out->sun_color[1] = key->sun_color.g;
+    out->sun_color[2] = key->sun_color.b;
+    out->sun_intensity = key->sun_intensity;
+    out->ambient_color[0] = key->ambient_color.r;
+    out->ambient_color[1] = key->ambient_color.g;
+    out->ambient_color[2] = key->ambient_color.b;
+}
+
+static
+void tod_sample_lerp(
+    const ecs_time_of_day_sample_t *a,
+    const ecs_time_of_day_sample_t *b,
+    float f,
+    ecs_time_of_day_sample_t *out)
+{
+    glm_vec3_lerp((float*)a->sun_color, (float*)b->sun_color, f,
+        out->sun_color);
+    glm_vec3_lerp((float*)a->ambient_color, (float*)b->ambient_color, f,
+        out->ambient_color);
+    out->sun_intensity = glm_lerp(a->sun_intensity, b->sun_intensity, f);
+}
+
+/* Piecewise linear interpolation between curve keys, which are sorted by
+ * sun height. Heights outside of the key range clamp to the first/last key. */
+static
+void tod_eval_curve(
+    const EcsTimeOfDayCurve *curve,
+    int32_t count,
+    float sun_height,
+    ecs_time_of_day_sample_t *out)
+{
+    const ecs_time_of_day_key_t *keys = curve->keys;
+    if (sun_height <= keys[0].sun_height) {
+        tod_key_to_sample(&keys[0], out);
+        return;
+    }
+
+    for (int32_t k = 1; k < count; k ++) {
+        if (sun_height <= keys[k].sun_height) {
+            ecs_time_of_day_sample_t a, b;
+            tod_key_to_sample(&keys[k - 1], &a);
+            tod_key_to_sample(&keys[k], &b);
+            float range = keys[k].sun_height - keys[k - 1].sun_height;
+            float f = 0;
+            if (range > 0) {
+                f = (sun_height - keys[k - 1].sun_height) / range;
+            }
+            tod_sample_lerp(&a, &b, f, out);
+            return;
+        }
+    }
+
+    tod_key_to_sample(&keys[count - 1], out);
+}
+
+static
+void tod_bake(
+    EcsTimeOfDayTable *table,
+    const EcsTimeOfDayCurve *curve)
+{
+    int32_t count = 0;
+    if (curve) {
+        count = curve->count;
+        if (count > FLECS_GAME_TIME_OF_DAY_KEYS_MAX) {
+            count = FLECS_GAME_TIME_OF_DAY_KEYS_MAX;
+        }
+    }
+
+    for (int32_t i = 0; i < TOD_LUT_SIZE; i ++) {
+        float t = 2.0 * (float)i / (float)TOD_LUT_SIZE;
+        float sun_height = get_sun_height(t);
+        if (count > 0) {
+            tod_eval_curve(curve, count, sun_height, &table->samples[i]);
+        } else {
+            tod_eval_default(sun_height, &table->samples[i]);
+        }
+    }
+
+    /* Extra sample so that lookups can interpolate without wrapping */
+    table->samples[TOD_LUT_SIZE] = table->samples[0];
+}
+
+void ecs_time_of_day_sample(
+    const EcsTimeOfDayTable *table,
+    float t,
+    ecs_time_of_day_sample_t *out)
+{
+    /* The day cycle repeats every 2 units of t */
+    float phase = t * 0.5f;
+    phase -= floorf(phase);
+
+    float x = phase * TOD_LUT_SIZE;
+    int32_t i = (int32_t)x;
+    if (i >= TOD_LUT_SIZE) {
+        i = TOD_LUT_SIZE - 1;
+    }
+
+    tod_sample_lerp(&table->samples[i], &table->samples[i + 1], x - i, out);
+}
+
+float ecs_time_of_day_sun_angle(float t) {
+    return get_time_of_day(t);
+}
+
+static
+void TimeOfDayUpdate(ecs_iter_t *it) {
+    EcsTimeOfDay *tod = ecs_field(it, EcsTimeOfDay, 1);
+    tod->t += it->delta_time * tod->speed;
+}
+
+static
+void SetTimeOfDayCurve(ecs_iter_t *it) {
+    EcsTimeOfDayCurve *curve = ecs_field(it, EcsTimeOfDayCurve, 1);
+    const EcsTimeOfDayCurve *bake = &curve[it->count - 1];
+
+    if (it->event == EcsOnRemove) {
+        /* Don't add the table back if it was already deleted, which happens
+         * when the curve is removed while the world is cleaned up */
+        if (!ecs_singleton_get(it->world, EcsTimeOfDayTable)) {
+            return;
+        }
+        bake = NULL;
+    }
+
+    EcsTimeOfDayTable *table = ecs_singleton_get_mut(
+        it->world, EcsTimeOfDayTable);
+    tod_bake(table, bake);
+    ecs_singleton_modified(it->world, EcsTimeOfDayTable);
+}
+
+void FlecsGameTimeOfDayImport(ecs_world_t *world) {
+    ECS_COMPONENT_DEFINE(world, EcsTimeOfDayTable);
+
+    ecs_set_hooks(world, EcsTimeOfDay, {
+        .ctor = ecs_default_ctor
+    });
+
+    ecs_set_hooks(world, EcsTimeOfDayCurve, {
+        .ctor = ecs_default_ctor
+    });
+
+    ECS_SYSTEM(world, TimeOfDayUpdate, EcsOnUpdate,
+        [inout]   TimeOfDay($));
+
+    ecs_observer(world, {
+        .entity = ecs_entity(world, { .name = "SetTimeOfDayCurve" }),
+        .filter.terms = {{ .id = ecs_id(EcsTimeOfDayCurve) }},
+        .events = { EcsOnSet, EcsOnRemove },
+        .callback = SetTimeOfDayCurve
+    });
+
+    EcsTimeOfDayTable *table = ecs_singleton_get_mut(world, EcsTimeOfDayTable);
+    tod_bake(table, NULL);
+    ecs_singleton_modified(world, EcsTimeOfDayTable);
+}
@@ -0,0 +1,226 @@
+#include <flecs_game_core.h>
+
+typedef struct {
+    uint32_t key;
+    int32_t row;
+} flecs_game_sort_elem_t;
+
+typedef struct {
+    int64_t migrations;    /* Migration count at the start of the last pass */
+    int32_t cursor;        /* Index of the next table to sort in the pass */
+    bool active;           /* Whether a pass is in progress */
+    ecs_vec_t elems;       /* vector<flecs_game_sort_elem_t> */
+    ecs_vec_t rows;        /* vector<int32_t>, original row -> current row */
+    ecs_vec_t origs;       /* vector<int32_t>, current row -> original row */
+} flecs_game_sort_ctx_t;
+
+static
+void flecs_game_sort_ctx_free(
+    void *ptr)
+{
+    flecs_game_sort_ctx_t *ctx = ptr;
+    ecs_vec_fini_t(NULL, &ctx->elems, flecs_game_sort_elem_t);
+    ecs_vec_fini_t(NULL, &ctx->rows, int32_t);
+    ecs_vec_fini_t(NULL, &ctx->origs, int32_t);
+    ecs_os_free(ctx);
+}
+
+/* Spread the lower 16 bits of v over the even bits of the result */
+static
+uint32_t flecs_game_morton_spread(
+    uint32_t v)
+{
+    v &= 0xFFFF;
+    v = (v | (v << 8)) & 0x00FF00FF;
+    v = (v | (v << 4)) & 0x0F0F0F0F;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+}
+
+/* Quantized offset of a coordinate from the lower bound of its world cell. The
+ * bound comes from ecs_world_cell_lower, so that coordinates in the (-1, 0)
+ * strip of cell 0 are at the start of the cell. */
+static
+uint32_t flecs_game_morton_offset(
+    float v)
+{
+    float offset = v - ecs_world_cell_lower(ecs_world_cell_index(v));
+    float q = offset * (65535.0f / FLECS_GAME_WORLD_CELL_SIZE);
+    if (q <= 0) {
+        return 0;
+    } else if (q >= 65535.0f) {
+        return 65535; /* Cell 0 is one unit wider than other cells */
+    }
+    return (uint32_t)q;
+}
+
+/* Z-order key of a position within its world cell */
+static
+uint32_t flecs_game_morton_key(
+    const EcsPosition3 *p)
+{
+    uint32_t qx = flecs_game_morton_offset(p->x);
+    uint32_t qz = flecs_game_morton_offset(p->z);
+    return flecs_game_morton_spread(qx) | (flecs_game_morton_spread(qz) << 1);
+}
+
+static
+int flecs_game_sort_elem_compare(
+    const void *ptr_1,
+    const void *ptr_2)
+{
+    const flecs_game_sort_elem_t *e1 = ptr_1, *e2 = ptr_2;
+    if (e1->key != e2->key) {
+        return e1->key < e2->key ? -1 : 1;
+    }
+    return (e1->row > e2->row) - (e1->row < e2->row);
+}
+
+/* Reorder rows of table in Z-order. Returns whether rows were moved. */
+static
+bool flecs_game_sort_table(
+    ecs_world_t *world,
+    flecs_game_sort_ctx_t *ctx,
+    ecs_table_t *table,
+    const EcsPosition3 *p,
+    int32_t count)
+{
+    ecs_vec_set_count_t(NULL, &ctx->elems, flecs_game_sort_elem_t, count);
+    flecs_game_sort_elem_t *elems = ecs_vec_first_t(
+        &ctx->elems, flecs_game_sort_elem_t);
+
+    bool sorted = true;
+    for (int32_t i = 0; i < count; i ++) {
+        elems[i].key = flecs_game_morton_key(&p[i]);
+        elems[i].row = i;
+        if (i && elems[i].key < elems[i - 1].key) {
+            sorted = false;
+        }
+    }
+
+    /* Tables in which entities didn't move far are often already sorted */
+    if (sorted) {
+        return false;
+    }
+
+    qsort(elems, count, sizeof(flecs_game_sort_elem_t),
+        flecs_game_sort_elem_compare);
+
+    ecs_vec_set_count_t(NULL, &ctx->rows, int32_t, count);
+    ecs_vec_set_count_t(NULL, &ctx->origs, int32_t, count);
+    int32_t *rows = ecs_vec_first_t(&ctx->rows, int32_t);
+    int32_t *origs = ecs_vec_first_t(&ctx->origs, int32_t);
+    for (int32_t i = 0; i < count; i ++) {
+        rows[i] = origs[i] = i;
+    }
+
+    /* Apply the permutation with at most count - 1 swaps */
+    for (int32_t i = 0; i < count; i ++) {
+        int32_t cur = rows[elems[i].row];
+        if (cur == i) {
+            continue;
+        }
+
+        ecs_table_swap_rows(world, table, i, cur);
+
+        int32_t orig_i = origs[i];
+        origs[cur] = orig_i;
+        rows[orig_i] = cur;
+        origs[i] = elems[i].row;
+        rows[elems[i].row] = i;
+    }
+
+    return true;
+}
+
+static
+void flecs_game_sort_tables(ecs_iter_t *it) {
+    ecs_world_t *world = it->world;
+    flecs_game_sort_ctx_t *ctx = it->ctx;
+    const EcsWorldCellSort *cfg = ecs_singleton_get(world, EcsWorldCellSort);
+    const EcsGameStats *stats = ecs_singleton_get(world, EcsGameStats);
+
+    if (!cfg || !stats) {
+        ecs_iter_fini(it);
+        return;
+    }
+
+    /* Start a pass over all tables once enough entities changed cells */
+    if (!ctx->active) {
+        int64_t migrations = stats->cell_migrations_total - ctx->migrations;
+        if (migrations < cfg->migration_threshold) {
+            ecs_iter_fini(it);
+            return;
+        }
+
+        ctx->migrations = stats->cell_migrations_total;
+        ctx->cursor = 0;
+        ctx->active = true;
+    }
+
+    int32_t budget = cfg->tables_per_frame;
+    int32_t index = 0, sorted = 0;
+    while (ecs_query_next_table(it)) {
+        if (index ++ < ctx->cursor) {
+            continue;
+        }
+
+        if (budget && sorted == budget) {
+            ecs_iter_fini(it);
+            ctx->cursor = index - 1;
+            return;
+        }
+
+        ecs_query_populate(it, false);
+        EcsPosition3 *p = ecs_field(it, EcsPosition3, 1);
+        if (it->count > 1) {
+            flecs_game_sort_table(world, ctx, it->table, p, it->count);
+        }
+
+        sorted ++;
+    }
+
+    ctx->active = false;
+}
+
+static
+void WorldCellSort(ecs_iter_t *it) {
+    ecs_time_t t = {0};
+    ecs_time_measure(&t);
+
+    flecs_game_sort_tables(it);
+
+    EcsGameStats *stats = ecs_singleton_get_mut(it->world, EcsGameStats);
+    stats->world_cell_sort_time = ecs_time_measure(&t);
+    ecs_singleton_modified(it->world, EcsGameStats);
+}
+
+void FlecsGameWorldCellSortImport(ecs_world_t *world) {
+    flecs_game_sort_ctx_t *ctx = ecs_os_calloc_t(flecs_game_sort_ctx_t);
+
+    /* Moves rows in tables directly, so it can't run while other systems are
+     * iterating tables. */
+    ecs_system(world, {
+        .entity = ecs_entity(world, {
+            .name = "WorldCellSort",
+            .add = { ecs_dependson(EcsPostFrame) }
+        }),
+        .query.filter.terms = {{
+            .id = ecs_id(EcsPosition3),
+            .src.flags = EcsSelf,
+            .inout = EcsIn
+        }, {
+            .id = ecs_pair(EcsWorldCell, EcsWildcard),
+            .inout = EcsInOutNone
+        }, {
+            .id = ecs_id(EcsGameStats),
+            .src.flags = EcsIsEntity,
+            .inout = EcsOut
+        }},
+        .run = WorldCellSort,
+        .no_readonly = true,
+        .ctx = ctx,
+        .ctx_free = flecs_game_sort_ctx_free
+    });
+}
@@ -0,0 +1,308 @@
+#include <flecs_game_core.h>
+
+ECS_DECLARE(EcsWorldCell);
+ECS_DECLARE(EcsWorldCellRoot);
+ECS_COMPONENT_DECLARE(WorldCells);
+
+typedef struct ecs_world_quadrant_t {
+    ecs_map_t cells;
+} ecs_world_quadrant_t;
+
+typedef struct WorldCells {
+    ecs_world_quadrant_t quadrants[4];
+} WorldCells;
+
+/* Counters, published to the GameStats singleton once per frame. Shared by the
+ * world cell systems through their ctx, so that updating them doesn't change
+ * the components the systems access. */
+typedef struct {
+    int32_t cells_created;
+    int32_t cell_migrations;
+    int64_t cells_created_total;
+    int64_t cell_migrations_total;
+    float update_world_cell_time;
+} flecs_game_cell_counters_t;
+
+typedef struct {
+    flecs_game_cell_counters_t counters;
+    ecs_query_t *changed;  /* Entities in cells, used to find changed tables */
+    ecs_map_t tables;      /* set<ecs_table_t*> changed this frame */
+} flecs_game_cell_ctx_t;
+
+static
+void flecs_game_cell_ctx_free(
+    void *ptr)
+{
+    flecs_game_cell_ctx_t *ctx = ptr;
+    ecs_map_fini(&ctx->tables);
+    ecs_os_free(ctx);
+}
+
+/* Get quadrant & spatial hash for signed cell index */
+static
+uint64_t flecs_game_cell_key(
+    int32_t x,
+    int32_t y,
+    int8_t *quadrant_out)
+{
+    uint8_t left = x < 0;
+    uint8_t bottom = y < 0;
+    uint64_t ax = left ? -(x + 1) : x;
+    uint64_t ay = bottom ? -(y + 1) : y;
+    *quadrant_out = left + bottom * 2;
+    return ax + (ay << 32);
+}
+
+static
+ecs_entity_t flecs_game_get_cell(
+    ecs_world_t *world,
+    WorldCells *wcells,
+    flecs_game_cell_counters_t *counters,
+    int32_t x,
+    int32_t y)
+{
+    int8_t quadrant;
+    uint64_t cell_id = flecs_game_cell_key(x, y, &quadrant);
+    ecs_entity_t *cell_ptr = ecs_map_ensure(
+        &wcells->quadrants[quadrant].cells, cell_id);
+    ecs_entity_t cell = *cell_ptr;
+    if (!cell) {
+        cell = *cell_ptr = ecs_new(world, EcsWorldCell);
+        ecs_add_pair(world, cell, EcsChildOf, EcsWorldCellRoot);
+        counters->cells_created ++;
+        counters->cells_created_total ++;
+
+        int32_t size = 1 << FLECS_GAME_WORLD_CELL_SHIFT;
+        ecs_set(world, cell, EcsWorldCellCoord, {
+            .x = (int64_t)x * size + size / 2,
+            .y = (int64_t)y * size + size / 2,
+            .size = size
+        });
+    }
+    return cell;
+}
+
+int32_t ecs_world_cell_index(
+    float v)
+{
+    int32_t i = v;
+    if (i < 0) {
+        return -((-i) >> FLECS_GAME_WORLD_CELL_SHIFT) - 1;
+    }
+    return i >> FLECS_GAME_WORLD_CELL_SHIFT;
+}
+
+float ecs_world_cell_lower(
+    int32_t index)
+{
+    float lower = (float)index * FLECS_GAME_WORLD_CELL_SIZE;
+    if (index == 0) {
+        lower -= 1;
+    }
+    return lower;
+}
+
+ecs_entity_t ecs_world_cell_get(
+    const ecs_world_t *world,
+    int32_t x,
+    int32_t y)
+{
+    const WorldCells *wcells = ecs_singleton_get(world, WorldCells);
+    if (!wcells) {
+        return 0;
+    }
+
+    int8_t quadrant;
+    uint64_t cell_id = flecs_game_cell_key(x, y, &quadrant);
+    ecs_map_val_t *cell = ecs_map_get(
+        &wcells->quadrants[quadrant].cells, cell_id);
+    if (!cell) {
+        return 0;
+    }
+
+    return *cell;
+}
+
+ecs_entity_t ecs_world_cell_find(
+    const ecs_world_t *world,
+    float x,
+    float y)
+{
+    return ecs_world_cell_get(world, 
+        ecs_world_cell_index(x), ecs_world_cell_index(y));
+}
+
+/* Add existing cell entity to the index. Used when restoring snapshots. */
+void flecs_game_world_cell_register(
+    ecs_world_t *world,
+    int32_t x,
+    int32_t y,
+    ecs_entity_t cell)
+{
+    WorldCells *wcells = ecs_singleton_get_mut(world, WorldCells);
+
+    int8_t quadrant;
+    uint64_t cell_id = flecs_game_cell_key(x, y, &quadrant);
+    ecs_map_ensure(&wcells->quadrants[quadrant].cells, cell_id)[0] = cell;
+}
+
+/* Entities don't store their cell. The (WorldCell, cell) pair is exclusive and
+ * part of the table type, so all entities in a table are in the same cell,
+ * which is looked up once per table.
+ *
+ * Changed tables are found with a separate query that only tracks Position3,
+ * as the system query also writes WorldCells, which would otherwise make every
+ * table report a change when the cell index is modified. */
+static
+void UpdateWorldCell(ecs_iter_t *it) {
+    ecs_world_t *world = it->world;
+    flecs_game_cell_ctx_t *ctx = it->ctx;
+    flecs_game_cell_counters_t *counters = &ctx->counters;
+    ecs_time_t t = {0};
+    ecs_time_measure(&t);
+
+    ecs_map_clear(&ctx->tables);
+    ecs_iter_t qit = ecs_query_iter(world, ctx->changed);
+    while (ecs_query_next_table(&qit)) {
+        if (!ecs_query_changed(NULL, &qit)) {
+            ecs_query_skip(&qit);
+            continue;
+        }
+
+        /* Populating syncs the changed state of the table */
+        ecs_query_populate(&qit, false);
+        ecs_map_ensure(&ctx->tables, (uint64_t)(uintptr_t)qit.table);
+    }
+
+    while (ecs_query_next_table(it)) {
+        if (!ecs_map_get(&ctx->tables, (uint64_t)(uintptr_t)it->table)) {
+            ecs_query_skip(it);
+            continue;
+        }
+
+        ecs_query_populate(it, false);
+
+        EcsPosition3 *pos = ecs_field(it, EcsPosition3, 1);
+        WorldCells *wcells = ecs_field(it, WorldCells, 2);
+
+        bool in_cell = false;
+        int32_t cell_x = 0, cell_y = 0;
+        if (ecs_field_is_set(it, 3)) {
+            ecs_entity_t cur = ecs_pair_second(world, ecs_field_id(it, 3));
+            const EcsWorldCellCoord *coord = ecs_get(
+                world, cur, EcsWorldCellCoord);
+            if (coord) {
+                cell_x = ecs_world_cell_index(coord->x);
+                cell_y = ecs_world_cell_index(coord->y);
+                in_cell = true;
+            }
+        }
+
+        int32_t migrations = 0;
+        for (int i = 0; i < it->count; i ++) {
+            int32_t x = ecs_world_cell_index(pos[i].x);
+            int32_t y = ecs_world_cell_index(pos[i].z);
+            if (in_cell && x == cell_x && y == cell_y) {
+                continue;
+            }
+
+            ecs_entity_t cell = flecs_game_get_cell(
+                world, wcells, counters, x, y);
+            ecs_add_pair(world, it->entities[i], EcsWorldCell, cell);
+            migrations ++;
+        }
+
+        counters->cell_migrations += migrations;
+        counters->cell_migrations_total += migrations;
+    }
+
+    counters->update_world_cell_time += ecs_time_measure(&t);
+}
+
+/* Copy counters to the GameStats singleton and reset per-frame counters */
+static
+void WorldCellStats(ecs_iter_t *it) {
+    WorldCells *wcells = ecs_field(it, WorldCells, 1);
+    EcsGameStats *stats = ecs_field(it, EcsGameStats, 2);
+    flecs_game_cell_counters_t *counters = it->ctx;
+
+    stats->cell_count = 0;
+    for (int q = 0; q < 4; q ++) {
+        stats->cell_count += ecs_map_count(&wcells->quadrants[q].cells);
+    }
+
+    stats->cells_created = counters->cells_created;
+    stats->cells_created_total = counters->cells_created_total;
+    stats->cell_migrations = counters->cell_migrations;
+    stats->cell_migrations_total = counters->cell_migrations_total;
+    stats->update_world_cell_time = counters->update_world_cell_time;
+
+    counters->cells_created = 0;
+    counters->cell_migrations = 0;
+    counters->update_world_cell_time = 0;
+}
+
+void FlecsGameWorldCellsImport(ecs_world_t *world) {
+    ECS_COMPONENT_DEFINE(world, WorldCells);
+    ECS_ENTITY_DEFINE(world, EcsWorldCell, Tag, Exclusive);
+
+    ecs_set_hooks(world, WorldCells, {
+        .ctor = ecs_default_ctor
+    });
+
+    EcsWorldCellRoot = ecs_entity(world, {
+        .name = "::game.worldcells",
+        .root_sep = "::"
+    });
+
+    flecs_game_cell_ctx_t *ctx = ecs_os_calloc_t(flecs_game_cell_ctx_t);
+    ecs_map_init(&ctx->tables, NULL);
+    ctx->changed = ecs_query(world, {
+        .filter.expr =
+            "[in]     flecs.components.transform.Position3(self),"
+            "[none]   !flecs.game.WorldCell(self),"
+            "[none]   !flecs.components.transform.Position3(up(ChildOf)),"
+            "[none]   !(Target, ChildOf)"
+    });
+
+    /* New entities are matched through the optional cell pair, and are added
+     * to a cell with a single structural change. The cell pair is added with
+     * commands, which the last term declares so that the pipeline merges
+     * before systems that read cell membership. */
+    ecs_system(world, {
+        .entity = ecs_entity(world, {
+            .name = "UpdateWorldCell",
+            .add = { ecs_dependson(EcsOnValidate) }
+        }),
+        .query.filter.expr =
+            "[in]     flecs.components.transform.Position3(self),"
+            "[inout]  WorldCells($),"
+            "[none]   ?(flecs.game.WorldCell, *),"
+            "[none]   !flecs.game.WorldCell(self),"
+            "[none]   !flecs.components.transform.Position3(up(ChildOf)),"
+            "[none]   !(Target, ChildOf),"
+            "[out]    (flecs.game.WorldCell, *)()",
+        .run = UpdateWorldCell,
+        .ctx = ctx,
+        .ctx_free = flecs_game_cell_ctx_free
+    });
+
+    /* Counters are owned by UpdateWorldCell */
+    ecs_system(world, {
+        .entity = ecs_entity(world, {
+            .name = "WorldCellStats",
+            .add = { ecs_dependson(EcsPostFrame) }
+        }),
+        .query.filter.expr =
+            "[in]     WorldCells($),"
+            "[out]    GameStats($)",
+        .callback = WorldCellStats,
+        .ctx = &ctx->counters
+    });
+
+    WorldCells *wcells = ecs_singleton_get_mut(world, WorldCells);
+    ecs_map_init(&wcells->quadrants[0].cells, NULL);
+    ecs_map_init(&wcells->quadrants[1].cells, NULL);
+    ecs_map_init(&wcells->quadrants[2].cells, NULL);
+    ecs_map_init(&wcells->quadrants[3].cells, NULL);
+}
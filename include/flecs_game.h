@@ -10,13 +10,6 @@
 #define ECS_META_IMPL EXTERN // Ensure meta symbols are only defined once
 #endif
 
-// Number of bits to shift from x/y coordinate before creating the spatial hash.
-// Larger numbers create larger cells.
-#define FLECS_GAME_WORLD_CELL_SHIFT (8)
-
-// Convenience macro to get size of world cell
-#define FLECS_GAME_WORLD_CELL_SIZE (1 << FLECS_GAME_WORLD_CELL_SHIFT)
-
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -31,54 +24,129 @@ ECS_STRUCT(EcsCameraAutoMove, {
     float t;
 });
 
+// Record position and rotation of a camera to a path. Samples are taken at
+// most once every interval seconds.
 FLECS_GAME_API
-ECS_STRUCT(EcsTimeOfDay, {
+ECS_STRUCT(EcsCameraPathRecord, {
+    float interval;
     float t;
-    float speed;
 });
 
+// Play back a recorded camera path. The path is advanced by timestep every
+// frame regardless of the frame delta time, so that runs are reproducible. If
+// timestep is 0 the frame delta time is used.
 FLECS_GAME_API
-extern ECS_DECLARE(EcsWorldCell);
+ECS_STRUCT(EcsCameraPathPlay, {
+    float timestep;
+    float t;
+    bool loop;
+});
 
+// Added to a camera when a (non-looping) path has finished playing.
 FLECS_GAME_API
-extern ECS_DECLARE(EcsWorldCellRoot);
+extern ECS_DECLARE(EcsCameraPathDone);
 
+// Point or spot light with a limited range. Local lights are registered with
+// every world cell that overlaps with their range.
 FLECS_GAME_API
-ECS_STRUCT(EcsWorldCellCoord, {
-    int64_t x;
-    int64_t y;
-    int32_t size;
+ECS_STRUCT(EcsLocalLight, {
+    float range;
 });
 
+// Maximum number of shadow cascades
+#define FLECS_GAME_SHADOW_CASCADES_MAX (4)
+
+// Split distances (view space) and bounds (light space) of a shadow cascade.
 FLECS_GAME_API
-ECS_STRUCT(ecs_grid_slot_t, {
-    ecs_entity_t prefab;
-    float chance;
+ECS_STRUCT(ecs_shadow_cascade_t, {
+    float near_;
+    float far_;
+    float min[3];
+    float max[3];
 });
 
+// Computes shadow cascades for a directional light with a Rotation3, such as
+// the Sun. Cascades are fitted to the frustum of the camera and to the bounds
+// of occupied world cells, and are only recomputed when the camera moves more
+// than position_threshold or the camera/sun rotate more than angle_threshold
+// (radians). Unset thresholds default to 0.5 units and 0.01 radians. Cell bounds
+// are extruded between height_min and height_max.
+//
+// A renderer can use light_view with an orthographic projection of
+// (min.x, max.x, min.y, max.y, -max.z, -min.z) for each cascade.
 FLECS_GAME_API
-ECS_STRUCT(ecs_grid_coord_t, {
+ECS_STRUCT(EcsShadowCascades, {
+    ecs_entity_t camera;
     int32_t count;
-    float spacing;
-    float variation;
+    float lambda;
+    float max_distance;
+    float aspect;
+    float height_min;
+    float height_max;
+    float position_threshold;
+    float angle_threshold;
+    ecs_shadow_cascade_t cascades[4];
+    float light_view[16];
 });
 
-FLECS_GAME_API
-ECS_STRUCT(EcsGrid, {
-    ecs_grid_coord_t x;
-    ecs_grid_coord_t y;
-    ecs_grid_coord_t z;
-
-    EcsPosition3 border;
-    EcsPosition3 border_offset;
+// Maximum number of LOD levels
+#define FLECS_GAME_LOD_LEVELS_MAX (4)
 
+// Prefab variant used when a world cell is at least distance away.
+FLECS_GAME_API
+ECS_STRUCT(ecs_lod_level_t, {
     ecs_entity_t prefab;
-    ecs_grid_slot_t variations[20];
+    float distance;
 });
 
+// Levels of detail for a base prefab. Set on the base prefab, levels list
+// cheaper variants in order of increasing distance. Instances of the base
+// prefab or one of its variants switch prefab when the distance from the
+// nearest camera to their world cell crosses a level distance. All members
+// of a cell switch at the same time.
+FLECS_GAME_API
+ECS_STRUCT(EcsLod, {
+    ecs_lod_level_t levels[4];
+});
+
+// Import camera, light and shadow systems. Imports the core module. Use this
+// to add presentation to a world that already imported the core module.
+FLECS_GAME_API
+void FlecsGamePresentationImport(ecs_world_t *world);
+
+// Import core and presentation parts of the module.
 FLECS_GAME_API
 void FlecsGameImport(ecs_world_t *world);
 
+// Get local lights that overlap with the world cell that contains (x, y).
+FLECS_GAME_API
+const ecs_entity_t* ecs_world_cell_lights(
+    const ecs_world_t *world,
+    float x,
+    float y,
+    int32_t *count_out);
+
+// Save path recorded with CameraPathRecord to a binary file.
+FLECS_GAME_API
+int ecs_camera_path_save(
+    const ecs_world_t *world,
+    ecs_entity_t camera,
+    const char *filename);
+
+// Load path from a binary file. Add CameraPathPlay to the camera to play it.
+FLECS_GAME_API
+int ecs_camera_path_load(
+    ecs_world_t *world,
+    ecs_entity_t camera,
+    const char *filename);
+
+// Write the per-frame timings measured during playback to a CSV file.
+FLECS_GAME_API
+int ecs_camera_path_save_timings(
+    const ecs_world_t *world,
+    ecs_entity_t camera,
+    const char *filename);
+
 #ifdef __cplusplus
 }
 #endif
@@ -89,7 +157,7 @@ void FlecsGameImport(ecs_world_t *world);
 
 namespace flecs {
 
-struct game {
+struct game : game_core {
     static flecs::entity_t CameraController;
 
     game(flecs::world& ecs) {
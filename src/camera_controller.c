@@ -194,11 +194,12 @@ void CameraAutoMove(ecs_iter_t *it) {
 
     for (int i = 0; i < it->count; i ++) {
         EcsVelocity3 *vcur = &v[i];
-        m->t += dt;
-        if ((m->t < m->after) && (vcur->x || vcur->y || vcur->z)) {
-            m->t = 0;
+        EcsCameraAutoMove *mcur = &m[i];
+        mcur->t += dt;
+        if ((mcur->t < mcur->after) && (vcur->x || vcur->y || vcur->z)) {
+            mcur->t = 0;
         }
-        if (m->t > m->after) {
+        if (mcur->t > mcur->after) {
             vcur->z = 10;
         }
     }
@@ -225,36 +226,86 @@ void FlecsGameCameraControllerImport(ecs_world_t *world) {
         [none]   CameraController,
         [out]    !flecs.components.physics.AngularVelocity);
 
-    ECS_SYSTEM(world, CameraControllerSyncPosition, EcsOnUpdate,
-        [out]    flecs.components.graphics.Camera, 
-        [in]     flecs.components.transform.Position3,
-        [none]   CameraController);
-
-    ECS_SYSTEM(world, CameraControllerSyncRotation, EcsOnUpdate,
-        [out]    flecs.components.graphics.Camera, 
-        [in]     flecs.components.transform.Position3,
-        [in]     flecs.components.transform.Rotation3,
-        [none]   CameraController);
-
-    ECS_SYSTEM(world, CameraControllerSyncLookAt, EcsOnUpdate,
-        [out]    flecs.components.graphics.Camera, 
-        [in]     flecs.components.graphics.LookAt,
-        [none]   CameraController);
-
-    ECS_SYSTEM(world, CameraControllerAccelerate, EcsOnUpdate,
-        [in]     flecs.components.input.Input($),
-        [in]     flecs.components.transform.Rotation3,
-        [inout]  flecs.components.physics.Velocity3,
-        [inout]  flecs.components.physics.AngularVelocity,
-        [none]   CameraController);
-
-    ECS_SYSTEM(world, CameraControllerDecelerate, EcsOnUpdate,
-        [inout]  flecs.components.physics.Velocity3,
-        [inout]  flecs.components.physics.AngularVelocity,
-        [inout]  flecs.components.transform.Rotation3,
-        [none]   CameraController);
-
-    ECS_SYSTEM(world, CameraAutoMove, EcsOnUpdate,
-        [inout]  flecs.components.physics.Velocity3,
-        [inout]  CameraAutoMove);
+    /* Sync systems run after transforms have been updated for the frame */
+    ecs_system(world, {
+        .entity = ecs_entity(world, {
+            .name = "CameraControllerSyncPosition",
+            .add = { ecs_dependson(EcsPostUpdate) }
+        }),
+        .query.filter.expr =
+            "[out]    flecs.components.graphics.Camera,"
+            "[in]     flecs.components.transform.Position3,"
+            "[none]   CameraController",
+        .callback = CameraControllerSyncPosition,
+        .multi_threaded = true
+    });
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, {
+            .name = "CameraControllerSyncRotation",
+            .add = { ecs_dependson(EcsPostUpdate) }
+        }),
+        .query.filter.expr =
+            "[out]    flecs.components.graphics.Camera,"
+            "[in]     flecs.components.transform.Position3,"
+            "[in]     flecs.components.transform.Rotation3,"
+            "[none]   CameraController",
+        .callback = CameraControllerSyncRotation,
+        .multi_threaded = true
+    });
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, {
+            .name = "CameraControllerSyncLookAt",
+            .add = { ecs_dependson(EcsPostUpdate) }
+        }),
+        .query.filter.expr =
+            "[out]    flecs.components.graphics.Camera,"
+            "[in]     flecs.components.graphics.LookAt,"
+            "[none]   CameraController",
+        .callback = CameraControllerSyncLookAt,
+        .multi_threaded = true
+    });
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, {
+            .name = "CameraControllerAccelerate",
+            .add = { ecs_dependson(EcsOnUpdate) }
+        }),
+        .query.filter.expr =
+            "[in]     flecs.components.input.Input($),"
+            "[in]     flecs.components.transform.Rotation3,"
+            "[inout]  flecs.components.physics.Velocity3,"
+            "[inout]  flecs.components.physics.AngularVelocity,"
+            "[none]   CameraController",
+        .callback = CameraControllerAccelerate,
+        .multi_threaded = true
+    });
+
+    /* Rotation3 is inout, as the pitch of the camera is clamped */
+    ecs_system(world, {
+        .entity = ecs_entity(world, {
+            .name = "CameraControllerDecelerate",
+            .add = { ecs_dependson(EcsOnUpdate) }
+        }),
+        .query.filter.expr =
+            "[inout]  flecs.components.physics.Velocity3,"
+            "[inout]  flecs.components.physics.AngularVelocity,"
+            "[inout]  flecs.components.transform.Rotation3,"
+            "[none]   CameraController",
+        .callback = CameraControllerDecelerate,
+        .multi_threaded = true
+    });
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, {
+            .name = "CameraAutoMove",
+            .add = { ecs_dependson(EcsOnUpdate) }
+        }),
+        .query.filter.expr =
+            "[inout]  flecs.components.physics.Velocity3,"
+            "[inout]  CameraAutoMove",
+        .callback = CameraAutoMove,
+        .multi_threaded = true
+    });
 }
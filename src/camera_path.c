@@ -0,0 +1,340 @@
+#include <flecs_game.h>
+#include <stdio.h>
+
+#define CAMERA_PATH_MAGIC (0x50434746) /* "FGCP" */
+#define CAMERA_PATH_VERSION (1)
+
+ECS_DECLARE(EcsCameraPathDone);
+ECS_COMPONENT_DECLARE(CameraPath);
+
+typedef struct ecs_camera_path_sample_t {
+    float t;
+    float position[3];
+    float rotation[3];
+} ecs_camera_path_sample_t;
+
+typedef struct ecs_camera_path_frame_t {
+    int32_t frame;
+    float t;
+    float frame_time;
+} ecs_camera_path_frame_t;
+
+typedef struct ecs_camera_path_header_t {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t count;
+    uint32_t sample_size;
+} ecs_camera_path_header_t;
+
+typedef struct CameraPath {
+    ecs_vec_t samples;     /* vector<ecs_camera_path_sample_t> */
+    ecs_vec_t frames;      /* vector<ecs_camera_path_frame_t> */
+    ecs_time_t last_frame;
+} CameraPath;
+
+static ECS_DTOR(CameraPath, ptr, {
+    ecs_vec_fini_t(NULL, &ptr->samples, ecs_camera_path_sample_t);
+    ecs_vec_fini_t(NULL, &ptr->frames, ecs_camera_path_frame_t);
+})
+
+static ECS_MOVE(CameraPath, dst, src, {
+    ecs_vec_fini_t(NULL, &dst->samples, ecs_camera_path_sample_t);
+    ecs_vec_fini_t(NULL, &dst->frames, ecs_camera_path_frame_t);
+    *dst = *src;
+    ecs_os_zeromem(src);
+})
+
+static
+void camera_path_sample(
+    const CameraPath *path,
+    float t,
+    EcsPosition3 *p,
+    EcsRotation3 *r)
+{
+    int32_t count = ecs_vec_count(&path->samples);
+    const ecs_camera_path_sample_t *samples = ecs_vec_first_t(
+        &path->samples, ecs_camera_path_sample_t);
+
+    /* Find first sample with a timestamp larger than t */
+    int32_t lo = 0, hi = count;
+    while (lo < hi) {
+        int32_t mid = (lo + hi) / 2;
+        if (samples[mid].t <= t) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    const ecs_camera_path_sample_t *a, *b;
+    if (lo == 0) {
+        a = b = &samples[0];
+    } else if (lo == count) {
+        a = b = &samples[count - 1];
+    } else {
+        a = &samples[lo - 1];
+        b = &samples[lo];
+    }
+
+    float f = 0;
+    if (b->t > a->t) {
+        f = (t - a->t) / (b->t - a->t);
+    }
+
+    vec3 pos, rot;
+    glm_vec3_lerp((float*)a->position, (float*)b->position, f, pos);
+    glm_vec3_lerp((float*)a->rotation, (float*)b->rotation, f, rot);
+
+    p->x = pos[0]; p->y = pos[1]; p->z = pos[2];
+    r->x = rot[0]; r->y = rot[1]; r->z = rot[2];
+}
+
+static
+void CameraPathRecord(ecs_iter_t *it) {
+    EcsPosition3 *p = ecs_field(it, EcsPosition3, 1);
+    EcsRotation3 *r = ecs_field(it, EcsRotation3, 2);
+    EcsCameraPathRecord *rec = ecs_field(it, EcsCameraPathRecord, 3);
+    CameraPath *path = ecs_field(it, CameraPath, 4);
+
+    for (int i = 0; i < it->count; i ++) {
+        rec[i].t += it->delta_time;
+
+        int32_t count = ecs_vec_count(&path[i].samples);
+        if (count) {
+            ecs_camera_path_sample_t *last = ecs_vec_get_t(
+                &path[i].samples, ecs_camera_path_sample_t, count - 1);
+            if ((rec[i].t - last->t) < rec[i].interval) {
+                continue;
+            }
+        }
+
+        ecs_camera_path_sample_t *s = ecs_vec_append_t(
+            NULL, &path[i].samples, ecs_camera_path_sample_t);
+        s->t = rec[i].t;
+        s->position[0] = p[i].x;
+        s->position[1] = p[i].y;
+        s->position[2] = p[i].z;
+        s->rotation[0] = r[i].x;
+        s->rotation[1] = r[i].y;
+        s->rotation[2] = r[i].z;
+    }
+}
+
+static
+void CameraPathPlay(ecs_iter_t *it) {
+    EcsCameraPathPlay *play = ecs_field(it, EcsCameraPathPlay, 1);
+    CameraPath *path = ecs_field(it, CameraPath, 2);
+    EcsPosition3 *p = ecs_field(it, EcsPosition3, 3);
+    EcsRotation3 *r = ecs_field(it, EcsRotation3, 4);
+    EcsVelocity3 *v = ecs_field(it, EcsVelocity3, 5);
+    EcsAngularVelocity *av = ecs_field(it, EcsAngularVelocity, 6);
+
+    for (int i = 0; i < it->count; i ++) {
+        CameraPath *cur = &path[i];
+        int32_t count = ecs_vec_count(&cur->samples);
+        if (!count) {
+            continue;
+        }
+
+        /* Wall clock time between two playback frames. Because the path is
+         * advanced with a fixed timestep this measures the cost of a frame
+         * for the exact same camera position across runs. */
+        float frame_time = 0;
+        if (cur->last_frame.sec || cur->last_frame.nanosec) {
+            frame_time = (float)ecs_time_measure(&cur->last_frame);
+        } else {
+            ecs_os_get_time(&cur->last_frame);
+        }
+
+        ecs_camera_path_frame_t *frame = ecs_vec_append_t(
+            NULL, &cur->frames, ecs_camera_path_frame_t);
+        frame->frame = ecs_vec_count(&cur->frames) - 1;
+        frame->t = play[i].t;
+        frame->frame_time = frame_time;
+
+        camera_path_sample(cur, play[i].t, &p[i], &r[i]);
+
+        /* Make sure the camera controller doesn't move the camera */
+        if (ecs_field_is_set(it, 5)) {
+            v[i] = (EcsVelocity3){0};
+        }
+        if (ecs_field_is_set(it, 6)) {
+            av[i] = (EcsAngularVelocity){0};
+        }
+
+        float duration = ecs_vec_get_t(&cur->samples,
+            ecs_camera_path_sample_t, count - 1)->t;
+        /* Only mark the path done after the last sample has been applied */
+        if (!play[i].loop && play[i].t >= duration) {
+            ecs_add(it->world, it->entities[i], EcsCameraPathDone);
+            continue;
+        }
+
+        float step = play[i].timestep;
+        if (step <= 0) {
+            step = it->delta_time;
+        }
+
+        play[i].t += step;
+        if (play[i].t > duration) {
+            if (play[i].loop) {
+                play[i].t = 0;
+            } else {
+                play[i].t = duration;
+            }
+        }
+    }
+}
+
+int ecs_camera_path_save(
+    const ecs_world_t *world,
+    ecs_entity_t camera,
+    const char *filename)
+{
+    const CameraPath *path = ecs_get(world, camera, CameraPath);
+    if (!path) {
+        ecs_err("entity has no recorded camera path");
+        return -1;
+    }
+
+    FILE *f = fopen(filename, "wb");
+    if (!f) {
+        ecs_err("failed to open '%s' for writing", filename);
+        return -1;
+    }
+
+    ecs_camera_path_header_t hdr = {
+        .magic = CAMERA_PATH_MAGIC,
+        .version = CAMERA_PATH_VERSION,
+        .count = (uint32_t)ecs_vec_count(&path->samples),
+        .sample_size = sizeof(ecs_camera_path_sample_t)
+    };
+
+    int result = 0;
+    if (fwrite(&hdr, sizeof(hdr), 1, f) != 1) {
+        result = -1;
+    } else if (hdr.count && fwrite(ecs_vec_first(&path->samples),
+        sizeof(ecs_camera_path_sample_t), hdr.count, f) != hdr.count)
+    {
+        result = -1;
+    }
+
+    if (result) {
+        ecs_err("failed to write camera path to '%s'", filename);
+    }
+
+    fclose(f);
+    return result;
+}
+
+int ecs_camera_path_load(
+    ecs_world_t *world,
+    ecs_entity_t camera,
+    const char *filename)
+{
+    FILE *f = fopen(filename, "rb");
+    if (!f) {
+        ecs_err("failed to open '%s' for reading", filename);
+        return -1;
+    }
+
+    ecs_camera_path_header_t hdr;
+    if (fread(&hdr, sizeof(hdr), 1, f) != 1 ||
+        hdr.magic != CAMERA_PATH_MAGIC ||
+        hdr.version != CAMERA_PATH_VERSION ||
+        hdr.sample_size != sizeof(ecs_camera_path_sample_t))
+    {
+        ecs_err("'%s' is not a valid camera path file", filename);
+        fclose(f);
+        return -1;
+    }
+
+    CameraPath *path = ecs_get_mut(world, camera, CameraPath);
+    ecs_vec_set_count_t(NULL, &path->samples,
+        ecs_camera_path_sample_t, (int32_t)hdr.count);
+    ecs_vec_clear(&path->frames);
+    path->last_frame = (ecs_time_t){0};
+
+    int result = 0;
+    if (hdr.count && fread(ecs_vec_first(&path->samples),
+        sizeof(ecs_camera_path_sample_t), hdr.count, f) != hdr.count)
+    {
+        ecs_err("camera path file '%s' is truncated", filename);
+        ecs_vec_clear(&path->samples);
+        result = -1;
+    }
+
+    fclose(f);
+    ecs_modified(world, camera, CameraPath);
+    return result;
+}
+
+int ecs_camera_path_save_timings(
+    const ecs_world_t *world,
+    ecs_entity_t camera,
+    const char *filename)
+{
+    const CameraPath *path = ecs_get(world, camera, CameraPath);
+    if (!path) {
+        ecs_err("entity has no camera path");
+        return -1;
+    }
+
+    FILE *f = fopen(filename, "w");
+    if (!f) {
+        ecs_err("failed to open '%s' for writing", filename);
+        return -1;
+    }
+
+    const ecs_camera_path_frame_t *frames = ecs_vec_first_t(
+        &path->frames, ecs_camera_path_frame_t);
+    int32_t i, count = ecs_vec_count(&path->frames);
+
+    fprintf(f, "frame,t,frame_time_ms\n");
+    for (i = 0; i < count; i ++) {
+        fprintf(f, "%d,%f,%f\n", frames[i].frame, (double)frames[i].t,
+            (double)frames[i].frame_time * 1000.0);
+    }
+
+    fclose(f);
+    return 0;
+}
+
+void FlecsGameCameraPathImport(ecs_world_t *world) {
+    ECS_COMPONENT_DEFINE(world, CameraPath);
+    ECS_TAG_DEFINE(world, EcsCameraPathDone);
+
+    ecs_set_hooks(world, CameraPath, {
+        .ctor = ecs_default_ctor,
+        .dtor = ecs_dtor(CameraPath),
+        .move = ecs_move(CameraPath)
+    });
+
+    ecs_set_hooks(world, EcsCameraPathRecord, {
+        .ctor = ecs_default_ctor
+    });
+
+    ecs_set_hooks(world, EcsCameraPathPlay, {
+        .ctor = ecs_default_ctor
+    });
+
+    ecs_add_pair(world, ecs_id(EcsCameraPathRecord), EcsWith, ecs_id(CameraPath));
+    ecs_add_pair(world, ecs_id(EcsCameraPathPlay), EcsWith, ecs_id(CameraPath));
+
+    /* Runs after the controller and physics systems moved the camera, and
+     * before the camera sync systems, so the played back pose is exact. */
+    ECS_SYSTEM(world, CameraPathPlay, EcsOnValidate,
+        [inout]  CameraPathPlay,
+        [inout]  CameraPath,
+        [out]    flecs.components.transform.Position3,
+        [out]    flecs.components.transform.Rotation3,
+        [out]    ?flecs.components.physics.Velocity3,
+        [out]    ?flecs.components.physics.AngularVelocity,
+        [none]   !CameraPathDone);
+
+    ECS_SYSTEM(world, CameraPathRecord, EcsPostUpdate,
+        [in]     flecs.components.transform.Position3,
+        [in]     flecs.components.transform.Rotation3,
+        [inout]  CameraPathRecord,
+        [inout]  CameraPath);
+}
@@ -0,0 +1,424 @@
+#include <flecs_game.h>
+#include <float.h>
+
+ECS_COMPONENT_DECLARE(LodState);
+
+/* Table of which all entities switch to another variant */
+typedef struct {
+    ecs_table_t *table;
+    ecs_entity_t prefab;
+    ecs_entity_t variant;
+    int32_t offset;        /* Index of first entity in LodState::entities */
+    int32_t count;
+} lod_switch_t;
+
+/* Singleton with LOD bookkeeping */
+typedef struct LodState {
+    ecs_map_t variants;    /* map<variant prefab, base prefab> */
+    ecs_map_t cells;       /* map<cell, distance of last evaluation> */
+    ecs_map_t tables;      /* set<ecs_table_t*> that switch this frame */
+    ecs_vec_t switches;    /* vector<lod_switch_t> */
+    ecs_vec_t entities;    /* vector<ecs_entity_t> of switching tables */
+    ecs_vec_t thresholds;  /* vector<float>, distances of all LOD levels */
+    ecs_vec_t cameras;     /* vector<vec3>, camera positions for frame */
+    ecs_query_t *members;  /* Prefab instances in world cells */
+} LodState;
+
+static ECS_DTOR(LodState, ptr, {
+    ecs_map_fini(&ptr->variants);
+    ecs_map_fini(&ptr->cells);
+    ecs_map_fini(&ptr->tables);
+    ecs_vec_fini_t(NULL, &ptr->switches, lod_switch_t);
+    ecs_vec_fini_t(NULL, &ptr->entities, ecs_entity_t);
+    ecs_vec_fini_t(NULL, &ptr->thresholds, float);
+    ecs_vec_fini_t(NULL, &ptr->cameras, vec3);
+})
+
+static
+uint64_t lod_distance_to_val(
+    float d)
+{
+    uint32_t bits;
+    ecs_os_memcpy(&bits, &d, sizeof(float));
+    return bits;
+}
+
+static
+float lod_val_to_distance(
+    uint64_t val)
+{
+    uint32_t bits = (uint32_t)val;
+    float d;
+    ecs_os_memcpy(&d, &bits, sizeof(float));
+    return d;
+}
+
+/* Returns whether a LOD threshold lies between two distances */
+static
+bool lod_crossed(
+    const LodState *state,
+    float d1,
+    float d2)
+{
+    float lo = glm_min(d1, d2), hi = glm_max(d1, d2);
+    const float *thresholds = ecs_vec_first_t(&state->thresholds, float);
+    int32_t i, count = ecs_vec_count(&state->thresholds);
+    for (i = 0; i < count; i ++) {
+        if (thresholds[i] > lo && thresholds[i] <= hi) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static
+ecs_entity_t lod_select(
+    ecs_entity_t base,
+    const EcsLod *lod,
+    float distance)
+{
+    ecs_entity_t result = base;
+    for (int32_t i = 0; i < FLECS_GAME_LOD_LEVELS_MAX; i ++) {
+        const ecs_lod_level_t *level = &lod->levels[i];
+        if (!level->prefab) {
+            break;
+        }
+        if (distance >= level->distance) {
+            result = level->prefab;
+        }
+    }
+    return result;
+}
+
+/* Distance in the XZ plane from the nearest camera to the bounds of the cell */
+static
+float lod_cell_distance(
+    const LodState *state,
+    const EcsWorldCellCoord *coord)
+{
+    const vec3 *cameras = ecs_vec_first_t(&state->cameras, vec3);
+    int32_t i, count = ecs_vec_count(&state->cameras);
+    float half = coord->size / 2.0, result = FLT_MAX;
+
+    for (i = 0; i < count; i ++) {
+        float dx = fabs(cameras[i][0] - coord->x) - half;
+        float dz = fabs(cameras[i][2] - coord->y) - half;
+        dx = glm_max(0, dx);
+        dz = glm_max(0, dz);
+        float d = sqrt(dx * dx + dz * dz);
+        if (d < result) {
+            result = d;
+        }
+    }
+
+    return result;
+}
+
+/* Queue a switch for the entities of a table if they are not at the right
+ * level. All entities in a table share the same prefab, so they switch to the
+ * same variant. */
+static
+void lod_table(
+    ecs_world_t *world,
+    LodState *state,
+    ecs_table_t *table,
+    const ecs_entity_t *entities,
+    int32_t count,
+    ecs_entity_t prefab,
+    float distance)
+{
+    ecs_map_val_t *base = ecs_map_get(&state->variants, prefab);
+    if (!base) {
+        return;
+    }
+
+    const EcsLod *lod = ecs_get(world, base[0], EcsLod);
+    if (!lod) {
+        return;
+    }
+
+    ecs_entity_t variant = lod_select(base[0], lod, distance);
+    if (variant == prefab) {
+        return;
+    }
+
+    ecs_map_val_t *queued = ecs_map_ensure(
+        &state->tables, (uint64_t)(uintptr_t)table);
+    if (queued[0]) {
+        return;
+    }
+    queued[0] = 1;
+
+    lod_switch_t *sw = ecs_vec_append_t(NULL, &state->switches, lod_switch_t);
+    sw->table = table;
+    sw->prefab = prefab;
+    sw->variant = variant;
+    sw->offset = ecs_vec_count(&state->entities);
+    sw->count = count;
+    ecs_os_memcpy_n(ecs_vec_grow_t(NULL, &state->entities, ecs_entity_t, 
+        count), entities, ecs_entity_t, count);
+}
+
+/* Queue switches for the members of a cell that crossed a threshold */
+static
+void lod_update_cell(
+    ecs_world_t *world,
+    LodState *state,
+    ecs_entity_t cell,
+    float distance)
+{
+    ecs_iter_t it = ecs_term_iter(world, &(ecs_term_t){
+        .id = ecs_pair(EcsWorldCell, cell)
+    });
+
+    while (ecs_term_next(&it)) {
+        ecs_id_t isa = 0;
+        if (ecs_search(world, it.table, ecs_pair(EcsIsA, EcsWildcard), &isa) == -1) {
+            continue;
+        }
+
+        lod_table(world, state, it.table, it.entities, it.count,
+            ecs_pair_second(world, isa), distance);
+    }
+}
+
+/* Queue switches for tables that got new members since the last frame. Uses
+ * the distance of the last evaluation of the cell, which is in the same band
+ * as the current distance if the cell didn't cross a threshold. */
+static
+void lod_update_members(
+    ecs_world_t *world,
+    LodState *state)
+{
+    ecs_iter_t it = ecs_query_iter(world, state->members);
+    while (ecs_query_next_table(&it)) {
+        if (!ecs_query_changed(NULL, &it)) {
+            continue;
+        }
+
+        /* Populating syncs the change state of the table with the query */
+        ecs_query_populate(&it, false);
+
+        ecs_entity_t cell = ecs_pair_second(world, ecs_field_id(&it, 2));
+        ecs_map_val_t *last = ecs_map_get(&state->cells, cell);
+        if (!last) {
+            continue; /* Evaluated when the cell is visited */
+        }
+
+        lod_table(world, state, it.table, it.entities, it.count,
+            ecs_pair_second(world, ecs_field_id(&it, 1)),
+            lod_val_to_distance(last[0]));
+    }
+}
+
+/* Move the entities of queued tables to their variant. The destination table
+ * is looked up once per table, after which each entity is committed directly
+ * to it, which doesn't enqueue commands or traverse the table graph. */
+static
+void lod_apply(
+    ecs_world_t *world,
+    LodState *state)
+{
+    const lod_switch_t *switches = ecs_vec_first_t(
+        &state->switches, lod_switch_t);
+    const ecs_entity_t *entities = ecs_vec_first_t(
+        &state->entities, ecs_entity_t);
+    int32_t s, count = ecs_vec_count(&state->switches);
+    if (!count) {
+        return;
+    }
+
+    bool deferred = ecs_is_deferred(world);
+    if (deferred) {
+        ecs_defer_suspend(world);
+    }
+
+    for (s = 0; s < count; s ++) {
+        const lod_switch_t *sw = &switches[s];
+        ecs_id_t remove_id = ecs_pair(EcsIsA, sw->prefab);
+        ecs_id_t add_id = ecs_pair(EcsIsA, sw->variant);
+        ecs_table_t *dst = ecs_table_remove_id(world, sw->table, remove_id);
+        dst = ecs_table_add_id(world, dst, add_id);
+
+        ecs_type_t added = { .array = &add_id, .count = 1 };
+        ecs_type_t removed = { .array = &remove_id, .count = 1 };
+        for (int32_t i = 0; i < sw->count; i ++) {
+            ecs_entity_t e = entities[sw->offset + i];
+            ecs_record_t *r = ecs_record_find(world, e);
+            if (!r || r->table != sw->table) {
+                continue;
+            }
+            ecs_commit(world, e, r, dst, &added, &removed);
+        }
+    }
+
+    if (deferred) {
+        ecs_defer_resume(world);
+    }
+}
+
+static
+void LodUpdate(ecs_iter_t *it) {
+    ecs_world_t *world = it->world;
+    LodState *state = ecs_singleton_get_mut(world, LodState);
+
+    if (!ecs_map_count(&state->variants)) {
+        ecs_iter_fini(it);
+        return;
+    }
+
+    ecs_vec_clear(&state->cameras);
+    ecs_iter_t cit = ecs_term_iter(world, &(ecs_term_t){
+        .id = ecs_id(EcsCamera)
+    });
+    while (ecs_term_next(&cit)) {
+        EcsCamera *cam = ecs_field(&cit, EcsCamera, 1);
+        for (int i = 0; i < cit.count; i ++) {
+            glm_vec3_copy(cam[i].position,
+                *ecs_vec_append_t(NULL, &state->cameras, vec3));
+        }
+    }
+
+    if (!ecs_vec_count(&state->cameras)) {
+        ecs_iter_fini(it);
+        return;
+    }
+
+    ecs_map_clear(&state->tables);
+    ecs_vec_clear(&state->switches);
+    ecs_vec_clear(&state->entities);
+
+    /* Only visit the members of cells that crossed a threshold */
+    while (ecs_query_next_table(it)) {
+        ecs_query_populate(it, false);
+        EcsWorldCellCoord *coord = ecs_field(it, EcsWorldCellCoord, 1);
+
+        for (int i = 0; i < it->count; i ++) {
+            ecs_entity_t cell = it->entities[i];
+            float d = lod_cell_distance(state, &coord[i]);
+            ecs_map_val_t *last = ecs_map_get(&state->cells, cell);
+            if (last && !lod_crossed(state, lod_val_to_distance(last[0]), d)) {
+                continue;
+            }
+
+            ecs_map_ensure(&state->cells, cell)[0] = lod_distance_to_val(d);
+            lod_update_cell(world, state, cell, d);
+        }
+    }
+
+    lod_update_members(world, state);
+    lod_apply(world, state);
+}
+
+static
+bool lod_is_removed(
+    const ecs_iter_t *it,
+    ecs_entity_t base)
+{
+    for (int i = 0; i < it->count; i ++) {
+        if (it->entities[i] == base) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Rebuild variant map & thresholds when a LOD is set or removed */
+static
+void SetLod(ecs_iter_t *it) {
+    ecs_world_t *world = it->world;
+
+    /* Don't add the state back while the world is cleaned up */
+    if (it->event == EcsOnRemove && !ecs_singleton_get(world, LodState)) {
+        return;
+    }
+
+    LodState *state = ecs_singleton_get_mut(world, LodState);
+
+    ecs_map_clear(&state->variants);
+    ecs_map_clear(&state->cells);
+    ecs_vec_clear(&state->thresholds);
+
+    /* LODs are set on prefabs, which are not matched by default */
+    ecs_filter_t *f = ecs_filter(world, {
+        .terms = {
+            { .id = ecs_id(EcsLod), .inout = EcsIn, .src.flags = EcsSelf },
+            { .id = EcsPrefab, .oper = EcsOptional, .inout = EcsInOutNone }
+        }
+    });
+
+    ecs_iter_t lit = ecs_filter_iter(world, f);
+    while (ecs_filter_next(&lit)) {
+        EcsLod *lod = ecs_field(&lit, EcsLod, 1);
+        for (int i = 0; i < lit.count; i ++) {
+            ecs_entity_t base = lit.entities[i];
+            if (it->event == EcsOnRemove && lod_is_removed(it, base)) {
+                continue;
+            }
+
+            ecs_map_ensure(&state->variants, base)[0] = base;
+            for (int32_t l = 0; l < FLECS_GAME_LOD_LEVELS_MAX; l ++) {
+                const ecs_lod_level_t *level = &lod[i].levels[l];
+                if (!level->prefab) {
+                    break;
+                }
+                ecs_map_ensure(&state->variants, level->prefab)[0] = base;
+                ecs_vec_append_t(NULL, &state->thresholds, float)[0] =
+                    level->distance;
+            }
+        }
+    }
+
+    ecs_filter_fini(f);
+}
+
+void FlecsGameLodImport(ecs_world_t *world) {
+    ECS_COMPONENT_DEFINE(world, LodState);
+
+    ecs_set_hooks(world, LodState, {
+        .ctor = ecs_default_ctor,
+        .dtor = ecs_dtor(LodState)
+    });
+
+    ecs_set_hooks(world, EcsLod, {
+        .ctor = ecs_default_ctor
+    });
+
+    /* Runs after the camera sync systems. Moves entities between tables
+     * directly, so it can't run while other systems are iterating tables. */
+    ecs_system(world, {
+        .entity = ecs_entity(world, {
+            .name = "LodUpdate",
+            .add = { ecs_dependson(EcsPostUpdate) }
+        }),
+        .query.filter.terms = {{
+            .id = ecs_id(EcsWorldCellCoord),
+            .inout = EcsIn
+        }},
+        .run = LodUpdate,
+        .no_readonly = true
+    });
+
+    /* LODs are set on prefabs, which observers only match if a term refers to
+     * the Prefab tag. */
+    ecs_observer(world, {
+        .entity = ecs_entity(world, { .name = "SetLod" }),
+        .filter.terms = {
+            { .id = ecs_id(EcsLod), .src.flags = EcsSelf },
+            { .id = EcsPrefab, .oper = EcsOptional, .inout = EcsInOutNone }
+        },
+        .events = { EcsOnSet, EcsOnRemove },
+        .callback = SetLod
+    });
+
+    LodState *state = ecs_singleton_get_mut(world, LodState);
+    ecs_map_init(&state->variants, NULL);
+    ecs_map_init(&state->cells, NULL);
+    ecs_map_init(&state->tables, NULL);
+    state->members = ecs_query(world, {
+        .filter.terms = {
+            { .id = ecs_pair(EcsIsA, EcsWildcard), .inout = EcsInOutNone },
+            { .id = ecs_pair(EcsWorldCell, EcsWildcard), .inout = EcsInOutNone }
+        }
+    });
+}
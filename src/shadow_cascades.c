@@ -0,0 +1,465 @@
+#include <flecs_game.h>
+#include <float.h>
+
+/* Used when the thresholds of ShadowCascades are not set */
+#define SHADOW_POSITION_THRESHOLD (0.5)
+#define SHADOW_ANGLE_THRESHOLD (0.01)
+
+ECS_COMPONENT_DECLARE(ShadowCascadesCache);
+
+/* Camera & sun state the cascades were last computed for */
+typedef struct ShadowCascadesCache {
+    vec3 camera_position;
+    vec3 camera_forward;
+    vec3 light_direction;
+    bool valid;
+} ShadowCascadesCache;
+
+typedef struct {
+    vec3 min;
+    vec3 max;
+} shadow_aabb_t;
+
+/* Occupied world cells, shared by all cascades in a frame */
+typedef struct {
+    ecs_vec_t cells;       /* vector<EcsWorldCellCoord> */
+    ecs_map_t index;       /* map<cell, index in cells + 1> */
+    int64_t frame;
+} shadow_cascades_ctx_t;
+
+static
+void shadow_cascades_ctx_free(
+    void *ptr)
+{
+    shadow_cascades_ctx_t *ctx = ptr;
+    ecs_vec_fini_t(NULL, &ctx->cells, EcsWorldCellCoord);
+    ecs_map_fini(&ctx->index);
+    ecs_os_free(ctx);
+}
+
+static
+void shadow_aabb_init(
+    shadow_aabb_t *box)
+{
+    glm_vec3_broadcast(FLT_MAX, box->min);
+    glm_vec3_broadcast(-FLT_MAX, box->max);
+}
+
+static
+void shadow_aabb_add(
+    shadow_aabb_t *box,
+    mat4 light_view,
+    vec3 p)
+{
+    vec3 lp;
+    glm_mat4_mulv3(light_view, p, 1.0, lp);
+    glm_vec3_minv(box->min, lp, box->min);
+    glm_vec3_maxv(box->max, lp, box->max);
+}
+
+static
+bool shadow_aabb_overlaps_xy(
+    const shadow_aabb_t *a,
+    const shadow_aabb_t *b)
+{
+    return a->min[0] <= b->max[0] && a->max[0] >= b->min[0] &&
+           a->min[1] <= b->max[1] && a->max[1] >= b->min[1];
+}
+
+static
+void shadow_light_direction(
+    const EcsRotation3 *r,
+    vec3 out)
+{
+    out[0] = sin(r->y) * cos(r->x);
+    out[1] = sin(r->x);
+    out[2] = cos(r->y) * cos(r->x);
+}
+
+static
+bool shadow_cascades_moved(
+    const EcsShadowCascades *sc,
+    const ShadowCascadesCache *cache,
+    vec3 camera_position,
+    vec3 camera_forward,
+    vec3 light_direction)
+{
+    if (!cache->valid) {
+        return true;
+    }
+
+    float position_threshold = sc->position_threshold > 0 ?
+        sc->position_threshold : SHADOW_POSITION_THRESHOLD;
+    float angle_threshold = sc->angle_threshold > 0 ?
+        sc->angle_threshold : SHADOW_ANGLE_THRESHOLD;
+
+    if (glm_vec3_distance((float*)cache->camera_position, camera_position) >
+        position_threshold)
+    {
+        return true;
+    }
+
+    float cos_threshold = cos(angle_threshold);
+    if (glm_vec3_dot((float*)cache->camera_forward, camera_forward) <
+        cos_threshold)
+    {
+        return true;
+    }
+
+    if (glm_vec3_dot((float*)cache->light_direction, light_direction) <
+        cos_threshold)
+    {
+        return true;
+    }
+
+    return false;
+}
+
+/* Compute bounds of frustum slice between distances d_near and d_far */
+static
+void shadow_slice_bounds(
+    mat4 light_view,
+    vec3 position,
+    vec3 forward,
+    vec3 right,
+    vec3 up,
+    float tan_half_fov,
+    float aspect,
+    float d_near,
+    float d_far,
+    shadow_aabb_t *out)
+{
+    shadow_aabb_init(out);
+
+    float d[2] = {d_near, d_far};
+    for (int i = 0; i < 2; i ++) {
+        float h = d[i] * tan_half_fov;
+        float w = h * aspect;
+
+        vec3 center;
+        glm_vec3_scale(forward, d[i], center);
+        glm_vec3_add(center, position, center);
+
+        for (int c = 0; c < 4; c ++) {
+            vec3 corner, offset;
+            glm_vec3_scale(right, (c & 1) ? w : -w, offset);
+            glm_vec3_add(center, offset, corner);
+            glm_vec3_scale(up, (c & 2) ? h : -h, offset);
+            glm_vec3_add(corner, offset, corner);
+            shadow_aabb_add(out, light_view, corner);
+        }
+    }
+}
+
+/* Range of world cells that can overlap with the light space bounds of the
+ * slice. Corners of the bounds are projected along the light direction on the
+ * min/max height planes, and the cell range is the range of the projections.
+ * Returns false if the light is (almost) horizontal, in which case the range
+ * is unbounded. */
+static
+bool shadow_slice_cell_range(
+    const EcsShadowCascades *sc,
+    mat4 light_view,
+    const shadow_aabb_t *slice,
+    int32_t *x_min,
+    int32_t *y_min,
+    int32_t *x_max,
+    int32_t *y_max)
+{
+    mat4 inv;
+    vec3 dir;
+    glm_mat4_inv(light_view, inv);
+    glm_mat4_mulv3(inv, (vec3){0, 0, 1}, 0.0, dir);
+    if (fabs(dir[1]) < 0.01) {
+        return false;
+    }
+
+    float heights[2] = {sc->height_min, sc->height_max};
+    float min_x = FLT_MAX, min_z = FLT_MAX, max_x = -FLT_MAX, max_z = -FLT_MAX;
+    for (int c = 0; c < 4; c ++) {
+        vec3 base;
+        glm_mat4_mulv3(inv, (vec3){
+            (c & 1) ? slice->max[0] : slice->min[0],
+            (c & 2) ? slice->max[1] : slice->min[1],
+            0
+        }, 1.0, base);
+
+        for (int h = 0; h < 2; h ++) {
+            float t = (heights[h] - base[1]) / dir[1];
+            float x = base[0] + t * dir[0];
+            float z = base[2] + t * dir[2];
+            min_x = glm_min(min_x, x);
+            min_z = glm_min(min_z, z);
+            max_x = glm_max(max_x, x);
+            max_z = glm_max(max_z, z);
+        }
+    }
+
+    *x_min = ecs_world_cell_index(min_x);
+    *y_min = ecs_world_cell_index(min_z);
+    *x_max = ecs_world_cell_index(max_x);
+    *y_max = ecs_world_cell_index(max_z);
+    return true;
+}
+
+/* Collect occupied world cells. Done at most once per frame, and only in
+ * frames in which cascades are recomputed. Cells are found through the tables
+ * of their members, so each member table is visited once. */
+static
+void shadow_occupancy_update(
+    ecs_world_t *world,
+    shadow_cascades_ctx_t *ctx)
+{
+    int64_t frame = ecs_get_world_info(world)->frame_count_total;
+    if (ctx->frame == frame) {
+        return;
+    }
+
+    ctx->frame = frame;
+    ecs_vec_clear(&ctx->cells);
+    ecs_map_clear(&ctx->index);
+
+    ecs_iter_t it = ecs_term_iter(world, &(ecs_term_t){
+        .id = ecs_pair(EcsWorldCell, EcsWildcard)
+    });
+
+    while (ecs_term_next(&it)) {
+        ecs_entity_t cell = ecs_pair_second(world, ecs_field_id(&it, 1));
+        if (ecs_map_get(&ctx->index, cell)) {
+            continue;
+        }
+
+        const EcsWorldCellCoord *coord = ecs_get(world, cell, EcsWorldCellCoord);
+        if (!coord) {
+            continue;
+        }
+
+        ecs_vec_append_t(NULL, &ctx->cells, EcsWorldCellCoord)[0] = coord[0];
+        ecs_map_insert(&ctx->index, cell, 
+            (ecs_map_val_t)ecs_vec_count(&ctx->cells));
+    }
+}
+
+/* Add cell to bounds if it overlaps with the slice */
+static
+bool shadow_cell_add(
+    const EcsShadowCascades *sc,
+    mat4 light_view,
+    const shadow_aabb_t *slice,
+    const EcsWorldCellCoord *coord,
+    shadow_aabb_t *out)
+{
+    float half = coord->size / 2.0;
+    shadow_aabb_t cell;
+    shadow_aabb_init(&cell);
+
+    for (int c = 0; c < 8; c ++) {
+        vec3 corner = {
+            coord->x + ((c & 1) ? half : -half),
+            (c & 2) ? sc->height_max : sc->height_min,
+            coord->y + ((c & 4) ? half : -half)
+        };
+        shadow_aabb_add(&cell, light_view, corner);
+    }
+
+    if (!shadow_aabb_overlaps_xy(&cell, slice)) {
+        return false;
+    }
+
+    glm_vec3_minv(out->min, cell.min, out->min);
+    glm_vec3_maxv(out->max, cell.max, out->max);
+    return true;
+}
+
+/* Bounds of all occupied world cells that overlap with the frustum slice. The
+ * cells are extruded between the configured min/max heights. Only cells in the
+ * range that can overlap with the slice are visited, unless the occupied cells
+ * are fewer than the cells in the range. */
+static
+bool shadow_cell_bounds(
+    ecs_world_t *world,
+    shadow_cascades_ctx_t *ctx,
+    const EcsShadowCascades *sc,
+    mat4 light_view,
+    const shadow_aabb_t *slice,
+    shadow_aabb_t *out)
+{
+    bool found = false;
+    shadow_aabb_init(out);
+    shadow_occupancy_update(world, ctx);
+
+    const EcsWorldCellCoord *cells = ecs_vec_first_t(
+        &ctx->cells, EcsWorldCellCoord);
+    int32_t i, count = ecs_vec_count(&ctx->cells);
+
+    int32_t x_min, y_min, x_max, y_max;
+    if (shadow_slice_cell_range(sc, light_view, slice, 
+        &x_min, &y_min, &x_max, &y_max))
+    {
+        int64_t area = (int64_t)(x_max - x_min + 1) * (y_max - y_min + 1);
+        if (area < count) {
+            for (int32_t x = x_min; x <= x_max; x ++) {
+                for (int32_t y = y_min; y <= y_max; y ++) {
+                    ecs_entity_t cell = ecs_world_cell_get(world, x, y);
+                    if (!cell) {
+                        continue;
+                    }
+
+                    ecs_map_val_t *index = ecs_map_get(&ctx->index, cell);
+                    if (!index) {
+                        continue; /* Not occupied */
+                    }
+
+                    found |= shadow_cell_add(sc, light_view, slice, 
+                        &cells[index[0] - 1], out);
+                }
+            }
+            return found;
+        }
+    }
+
+    for (i = 0; i < count; i ++) {
+        found |= shadow_cell_add(sc, light_view, slice, &cells[i], out);
+    }
+
+    return found;
+}
+
+static
+void ShadowCascadesUpdate(ecs_iter_t *it) {
+    EcsRotation3 *r = ecs_field(it, EcsRotation3, 1);
+    EcsShadowCascades *sc = ecs_field(it, EcsShadowCascades, 2);
+    ShadowCascadesCache *cache = ecs_field(it, ShadowCascadesCache, 3);
+    shadow_cascades_ctx_t *ctx = it->ctx;
+    ecs_world_t *world = it->world;
+
+    for (int i = 0; i < it->count; i ++) {
+        EcsShadowCascades *cur = &sc[i];
+        const EcsCamera *cam = NULL;
+        if (cur->camera) {
+            cam = ecs_get(world, cur->camera, EcsCamera);
+        }
+        if (!cam) {
+            continue;
+        }
+
+        vec3 position, forward, right, up, light_dir;
+        glm_vec3_copy((float*)cam->position, position);
+        glm_vec3_sub((float*)cam->lookat, position, forward);
+        glm_vec3_normalize(forward);
+        shadow_light_direction(&r[i], light_dir);
+
+        if (!shadow_cascades_moved(cur, &cache[i], position, forward, light_dir)) {
+            continue;
+        }
+
+        glm_vec3_copy(position, cache[i].camera_position);
+        glm_vec3_copy(forward, cache[i].camera_forward);
+        glm_vec3_copy(light_dir, cache[i].light_direction);
+        cache[i].valid = true;
+
+        /* Camera basis */
+        vec3 world_up = {0, 1, 0};
+        glm_vec3_cross(forward, world_up, right);
+        if (glm_vec3_norm2(right) < 0.0001) {
+            glm_vec3_copy((vec3){1, 0, 0}, right);
+        }
+        glm_vec3_normalize(right);
+        glm_vec3_cross(right, forward, up);
+
+        /* Light view matrix at the origin, looking along the light direction.
+         * Points closer to the light have a larger z in light space. */
+        mat4 light_view;
+        vec3 eye = {0, 0, 0}, light_up = {0, 1, 0};
+        if (fabs(light_dir[1]) > 0.99) {
+            glm_vec3_copy((vec3){0, 0, 1}, light_up);
+        }
+        glm_lookat(eye, light_dir, light_up, light_view);
+        ecs_os_memcpy(cur->light_view, light_view, sizeof(mat4));
+
+        float near_ = cam->near_ > 0 ? cam->near_ : 0.1;
+        float far_ = cam->far_ > near_ ? cam->far_ : 1000.0;
+        if (cur->max_distance > near_ && cur->max_distance < far_) {
+            far_ = cur->max_distance;
+        }
+
+        float aspect = cur->aspect > 0 ? cur->aspect : 16.0 / 9.0;
+        float tan_half_fov = tan(cam->fov / 2.0);
+        int32_t count = glm_clamp(cur->count, 1,
+            FLECS_GAME_SHADOW_CASCADES_MAX);
+
+        /* Blend between logarithmic and uniform split scheme */
+        float split_near = near_;
+        for (int32_t c = 0; c < count; c ++) {
+            float p = (float)(c + 1) / (float)count;
+            float log_split = near_ * pow(far_ / near_, p);
+            float uni_split = near_ + (far_ - near_) * p;
+            float split_far = glm_lerp(uni_split, log_split, cur->lambda);
+
+            ecs_shadow_cascade_t *cascade = &cur->cascades[c];
+            cascade->near_ = split_near;
+            cascade->far_ = split_far;
+
+            shadow_aabb_t slice, cells;
+            shadow_slice_bounds(light_view, position, forward, right, up,
+                tan_half_fov, aspect, split_near, split_far, &slice);
+
+            if (shadow_cell_bounds(world, ctx, cur, light_view, &slice, &cells)) {
+                /* Only cover the part of the slice that has geometry, and
+                 * extend the depth range towards the light so that all
+                 * casters that can shadow the slice are included. */
+                slice.min[0] = glm_max(slice.min[0], cells.min[0]);
+                slice.min[1] = glm_max(slice.min[1], cells.min[1]);
+                slice.max[0] = glm_min(slice.max[0], cells.max[0]);
+                slice.max[1] = glm_min(slice.max[1], cells.max[1]);
+                slice.min[2] = glm_max(slice.min[2], cells.min[2]);
+                slice.max[2] = glm_max(slice.max[2], cells.max[2]);
+            }
+
+            glm_vec3_copy(slice.min, cascade->min);
+            glm_vec3_copy(slice.max, cascade->max);
+            split_near = split_far;
+        }
+
+        for (int32_t c = count; c < FLECS_GAME_SHADOW_CASCADES_MAX; c ++) {
+            cur->cascades[c] = (ecs_shadow_cascade_t){0};
+        }
+    }
+}
+
+void FlecsGameShadowCascadesImport(ecs_world_t *world) {
+    ECS_COMPONENT_DEFINE(world, ShadowCascadesCache);
+
+    ecs_set_hooks(world, ShadowCascadesCache, {
+        .ctor = ecs_default_ctor
+    });
+
+    ecs_set_hooks(world, EcsShadowCascades, {
+        .ctor = ecs_default_ctor
+    });
+
+    ecs_add_pair(world, ecs_id(EcsShadowCascades), EcsWith,
+        ecs_id(ShadowCascadesCache));
+
+    shadow_cascades_ctx_t *ctx = ecs_os_calloc_t(shadow_cascades_ctx_t);
+    ecs_map_init(&ctx->index, NULL);
+    ctx->frame = -1;
+
+    /* Runs after the camera sync systems, which are created first. The camera
+     * is looked up with ecs_get, the Camera term tells the pipeline that the
+     * system reads it. Single threaded, as it shares the occupied cells. */
+    ecs_system(world, {
+        .entity = ecs_entity(world, {
+            .name = "ShadowCascadesUpdate",
+            .add = { ecs_dependson(EcsPostUpdate) }
+        }),
+        .query.filter.expr =
+            "[in]     flecs.components.transform.Rotation3,"
+            "[inout]  ShadowCascades,"
+            "[inout]  ShadowCascadesCache,"
+            "[in]     flecs.components.graphics.Camera()",
+        .callback = ShadowCascadesUpdate,
+        .ctx = ctx,
+        .ctx_free = shadow_cascades_ctx_free
+    });
+}
@@ -0,0 +1,249 @@
+#include <flecs_game.h>
+
+ECS_COMPONENT_DECLARE(WorldCellLights);
+ECS_COMPONENT_DECLARE(LocalLightCells);
+
+/* Per-cell light lists, indexed by signed world cell coordinate. A light is
+ * registered in every cell that overlaps with its range. */
+typedef struct WorldCellLights {
+    ecs_map_t cells; /* map<cell key, ecs_vec_t<ecs_entity_t>*> */
+} WorldCellLights;
+
+/* Range of cells a light is currently registered in */
+typedef struct LocalLightCells {
+    int32_t x_min;
+    int32_t y_min;
+    int32_t x_max;
+    int32_t y_max;
+    bool registered;
+} LocalLightCells;
+
+static
+uint64_t flecs_game_light_cell_key(
+    int32_t x,
+    int32_t y)
+{
+    return ((uint64_t)(uint32_t)x << 32) | (uint64_t)(uint32_t)y;
+}
+
+static ECS_DTOR(WorldCellLights, ptr, {
+    ecs_map_iter_t it = ecs_map_iter(&ptr->cells);
+    while (ecs_map_next(&it)) {
+        ecs_vec_t *lights = (ecs_vec_t*)(uintptr_t)ecs_map_value(&it);
+        ecs_vec_fini_t(NULL, lights, ecs_entity_t);
+        ecs_os_free(lights);
+    }
+    ecs_map_fini(&ptr->cells);
+})
+
+static
+void flecs_game_light_add(
+    WorldCellLights *wlights,
+    ecs_entity_t light,
+    const LocalLightCells *range)
+{
+    for (int32_t x = range->x_min; x <= range->x_max; x ++) {
+        for (int32_t y = range->y_min; y <= range->y_max; y ++) {
+            ecs_map_val_t *ptr = ecs_map_ensure(&wlights->cells,
+                flecs_game_light_cell_key(x, y));
+            ecs_vec_t *lights = (ecs_vec_t*)(uintptr_t)ptr[0];
+            if (!lights) {
+                lights = ecs_os_calloc_t(ecs_vec_t);
+                ptr[0] = (ecs_map_val_t)(uintptr_t)lights;
+            }
+            ecs_vec_append_t(NULL, lights, ecs_entity_t)[0] = light;
+        }
+    }
+}
+
+static
+void flecs_game_light_remove(
+    WorldCellLights *wlights,
+    ecs_entity_t light,
+    const LocalLightCells *range)
+{
+    for (int32_t x = range->x_min; x <= range->x_max; x ++) {
+        for (int32_t y = range->y_min; y <= range->y_max; y ++) {
+            uint64_t key = flecs_game_light_cell_key(x, y);
+            ecs_map_val_t *ptr = ecs_map_get(&wlights->cells, key);
+            if (!ptr) {
+                continue;
+            }
+
+            ecs_vec_t *lights = (ecs_vec_t*)(uintptr_t)ptr[0];
+            ecs_entity_t *array = ecs_vec_first_t(lights, ecs_entity_t);
+            int32_t i, count = ecs_vec_count(lights);
+            for (i = 0; i < count; i ++) {
+                if (array[i] == light) {
+                    ecs_vec_remove_t(lights, ecs_entity_t, i);
+                    break;
+                }
+            }
+
+            if (!ecs_vec_count(lights)) {
+                ecs_vec_fini_t(NULL, lights, ecs_entity_t);
+                ecs_os_free(lights);
+                ecs_map_remove(&wlights->cells, key);
+            }
+        }
+    }
+}
+
+static
+void UpdateLocalLightCells(ecs_iter_t *it) {
+    while (ecs_query_next_table(it)) {
+        if (!ecs_query_changed(NULL, it)) {
+            continue;
+        }
+
+        ecs_query_populate(it, false);
+
+        EcsPosition3 *p = ecs_field(it, EcsPosition3, 1);
+        EcsLocalLight *light = ecs_field(it, EcsLocalLight, 2);
+        LocalLightCells *cells = ecs_field(it, LocalLightCells, 3);
+        WorldCellLights *wlights = ecs_field(it, WorldCellLights, 4);
+        bool changed = false;
+
+        for (int i = 0; i < it->count; i ++) {
+            float range = light[i].range;
+            LocalLightCells next = {
+                .x_min = ecs_world_cell_index(p[i].x - range),
+                .y_min = ecs_world_cell_index(p[i].z - range),
+                .x_max = ecs_world_cell_index(p[i].x + range),
+                .y_max = ecs_world_cell_index(p[i].z + range),
+                .registered = true
+            };
+
+            LocalLightCells *cur = &cells[i];
+            if (cur->registered &&
+                cur->x_min == next.x_min && cur->y_min == next.y_min &&
+                cur->x_max == next.x_max && cur->y_max == next.y_max)
+            {
+                /* Light moved but still overlaps with the same cells */
+                continue;
+            }
+
+            if (cur->registered) {
+                flecs_game_light_remove(wlights, it->entities[i], cur);
+            }
+
+            flecs_game_light_add(wlights, it->entities[i], &next);
+            *cur = next;
+            changed = true;
+        }
+
+        if (!changed) {
+            ecs_query_skip(it);
+        }
+    }
+}
+
+/* Triggers for both terms when a light is deleted, which is harmless as the
+ * second invocation finds the light already unregistered. The singleton may
+ * already be gone when lights are removed during world teardown. */
+static
+void RemoveLocalLight(ecs_iter_t *it) {
+    ecs_world_t *world = it->world;
+    LocalLightCells *cells = ecs_field(it, LocalLightCells, 2);
+    const WorldCellLights *exists = ecs_singleton_get(world, WorldCellLights);
+    if (!exists || !ecs_map_is_init(&exists->cells)) {
+        return;
+    }
+
+    /* Singleton exists, so this doesn't create it */
+    WorldCellLights *wlights = ecs_singleton_get_mut(world, WorldCellLights);
+    bool changed = false;
+    for (int i = 0; i < it->count; i ++) {
+        if (cells[i].registered) {
+            flecs_game_light_remove(wlights, it->entities[i], &cells[i]);
+            cells[i].registered = false;
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        ecs_singleton_modified(world, WorldCellLights);
+    }
+}
+
+const ecs_entity_t* ecs_world_cell_lights(
+    const ecs_world_t *world,
+    float x,
+    float y,
+    int32_t *count_out)
+{
+    *count_out = 0;
+
+    const WorldCellLights *wlights = ecs_singleton_get(world, WorldCellLights);
+    if (!wlights) {
+        return NULL;
+    }
+
+    ecs_map_val_t *ptr = ecs_map_get(&wlights->cells,
+        flecs_game_light_cell_key(
+            ecs_world_cell_index(x), ecs_world_cell_index(y)));
+    if (!ptr) {
+        return NULL;
+    }
+
+    ecs_vec_t *lights = (ecs_vec_t*)(uintptr_t)ptr[0];
+    *count_out = ecs_vec_count(lights);
+    return ecs_vec_first_t(lights, ecs_entity_t);
+}
+
+void FlecsGameWorldCellLightsImport(ecs_world_t *world) {
+    ECS_COMPONENT_DEFINE(world, WorldCellLights);
+    ECS_COMPONENT_DEFINE(world, LocalLightCells);
+
+    ecs_set_hooks(world, WorldCellLights, {
+        .ctor = ecs_default_ctor,
+        .dtor = ecs_dtor(WorldCellLights)
+    });
+
+    ecs_set_hooks(world, LocalLightCells, {
+        .ctor = ecs_default_ctor
+    });
+
+    ecs_add_pair(world, ecs_id(EcsLocalLight), EcsWith, ecs_id(LocalLightCells));
+
+    ecs_system(world, {
+        .entity = ecs_entity(world, {
+            .name = "UpdateLocalLightCells",
+            .add = { ecs_dependson(EcsOnValidate) }
+        }),
+        .query = {
+            .filter.terms = {{
+                .id = ecs_id(EcsPosition3),
+                .inout = EcsIn,
+                .src.flags = EcsSelf
+            }, {
+                .id = ecs_id(EcsLocalLight),
+                .inout = EcsIn,
+                .src.flags = EcsSelf
+            }, {
+                .id = ecs_id(LocalLightCells),
+                .inout = EcsInOut,
+                .src.flags = EcsSelf
+            }, {
+                .id = ecs_id(WorldCellLights),
+                .inout = EcsInOut,
+                .src.flags = EcsSelf,
+                .src.id = ecs_id(WorldCellLights)
+            }}
+        },
+        .run = UpdateLocalLightCells
+    });
+
+    ecs_observer(world, {
+        .entity = ecs_entity(world, { .name = "RemoveLocalLight" }),
+        .filter.terms = {
+            { .id = ecs_id(EcsLocalLight) },
+            { .id = ecs_id(LocalLightCells) }
+        },
+        .events = { EcsOnRemove },
+        .callback = RemoveLocalLight
+    });
+
+    WorldCellLights *wlights = ecs_singleton_get_mut(world, WorldCellLights);
+    ecs_map_init(&wlights->cells, NULL);
+}
@@ -0,0 +1,7 @@
+#ifndef FLECS_GAME_TEST_CPP_H
+#define FLECS_GAME_TEST_CPP_H
+
+/* This generated file contains includes for project dependencies */
+#include "flecs-game-test-cpp/bake_config.h"
+
+#endif
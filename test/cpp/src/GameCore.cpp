@@ -0,0 +1,78 @@
+#include <flecs_game_test_cpp.h>
+
+struct Health {
+    int32_t value;
+};
+
+static
+flecs::entity spatial_entity(
+    flecs::world& world,
+    float x,
+    float z)
+{
+    return world.entity()
+        .set<EcsPosition3>({x, 0, z})
+        .set<Health>({10});
+}
+
+void GameCore_import(void) {
+    flecs::world world;
+    world.import<flecs::game_core>();
+
+    test_assert(world.lookup("flecs::game::core") != 0);
+    test_assert(world.lookup("flecs::game::WorldCellCoord") != 0);
+}
+
+void GameCore_each_in_cell(void) {
+    flecs::world world;
+    world.import<flecs::game_core>();
+
+    flecs::entity e1 = spatial_entity(world, 10, 10);
+    flecs::entity e2 = spatial_entity(world, 20, 10);
+    flecs::entity e3 = spatial_entity(world, 300, 10);
+
+    /* Not iterated, as it doesn't have Health */
+    world.entity().set<EcsPosition3>({30, 0, 10});
+
+    world.progress();
+
+    flecs::entity_t cell = ecs_world_cell_get(world, 0, 0);
+    test_assert(cell != 0);
+
+    int32_t count = 0;
+    flecs::game_core::each_in_cell<Health>(world, cell,
+        [&](flecs::entity e, Health& h) {
+            test_assert(e == e1 || e == e2);
+            test_int(h.value, 10);
+            h.value ++;
+            count ++;
+        });
+
+    test_int(count, 2);
+    test_int(e1.get<Health>()->value, 11);
+    test_int(e2.get<Health>()->value, 11);
+    test_int(e3.get<Health>()->value, 10);
+}
+
+void GameCore_each_in_radius(void) {
+    flecs::world world;
+    world.import<flecs::game_core>();
+
+    /* Range of the query overlaps with cells -1 and 0 */
+    flecs::entity e1 = spatial_entity(world, 10, 10);
+    flecs::entity e2 = spatial_entity(world, -10, 10);
+    spatial_entity(world, 20, 40);
+    spatial_entity(world, 300, 10);
+
+    world.progress();
+
+    int32_t count = 0;
+    flecs::game_core::each_in_radius<const Health>(world, {0, 0, 10}, 15,
+        [&](flecs::entity e, const Health& h) {
+            test_assert(e == e1 || e == e2);
+            test_int(h.value, 10);
+            count ++;
+        });
+
+    test_int(count, 2);
+}
@@ -0,0 +1,7 @@
+#ifndef FLECS_GAME_TEST_H
+#define FLECS_GAME_TEST_H
+
+/* This generated file contains includes for project dependencies */
+#include "flecs-game-test/bake_config.h"
+
+#endif
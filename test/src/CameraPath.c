@@ -0,0 +1,62 @@
+#include <flecs_game_test.h>
+#include <stdio.h>
+
+#define CAMERA_PATH_FILE "camera_path_test.bin"
+
+/* Record a path that moves 10 units along x every frame, for 10 frames */
+static
+void camera_path_record(
+    ecs_world_t *world)
+{
+    ecs_entity_t rec = ecs_new_id(world);
+    ecs_set(world, rec, EcsPosition3, {0, 0, 0});
+    ecs_set(world, rec, EcsRotation3, {0, 0, 0});
+    ecs_set(world, rec, EcsCameraPathRecord, { .interval = 0 });
+
+    for (int32_t i = 0; i < 10; i ++) {
+        ecs_set(world, rec, EcsPosition3, {i * 10.0f, 0, 0});
+        ecs_progress(world, 1);
+    }
+
+    test_int(ecs_camera_path_save(world, rec, CAMERA_PATH_FILE), 0);
+    ecs_delete(world, rec);
+}
+
+void CameraPath_play_with_controller(void) {
+    ecs_world_t *world = ecs_init();
+    ECS_IMPORT(world, FlecsGame);
+
+    camera_path_record(world);
+
+    /* Auto move adds velocity every frame, which physics integrates before
+     * the recorded pose is applied. */
+    ecs_entity_t camera = ecs_new_id(world);
+    ecs_add(world, camera, EcsCamera);
+    ecs_add(world, camera, EcsCameraController);
+    ecs_set(world, camera, EcsPosition3, {0, 0, 0});
+    ecs_set(world, camera, EcsRotation3, {0, 0, 0});
+    ecs_set(world, camera, EcsVelocity3, {0, 0, 0});
+    ecs_set(world, camera, EcsAngularVelocity, {0, 0, 0});
+    ecs_set(world, camera, EcsCameraAutoMove, { .after = 0 });
+    test_int(ecs_camera_path_load(world, camera, CAMERA_PATH_FILE), 0);
+    ecs_set(world, camera, EcsCameraPathPlay, { .timestep = 1 });
+
+    /* Samples are taken at t = 1 .. 10, playback starts at t = 0 */
+    for (int32_t i = 0; i < 10; i ++) {
+        ecs_progress(world, 1);
+
+        const EcsPosition3 *p = ecs_get(world, camera, EcsPosition3);
+        test_assert(p != NULL);
+        test_flt(p->x, glm_max(0, i - 1) * 10.0f);
+        test_flt(p->y, 0);
+        test_flt(p->z, 0);
+
+        const EcsCamera *cam = ecs_get(world, camera, EcsCamera);
+        test_assert(cam != NULL);
+        test_flt(cam->position[0], p->x);
+        test_flt(cam->position[2], p->z);
+    }
+
+    ecs_fini(world);
+    remove(CAMERA_PATH_FILE);
+}
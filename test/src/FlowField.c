@@ -0,0 +1,98 @@
+#include <flecs_game_test.h>
+
+/* Field that covers the world cells around cell (0, 0) */
+static
+ecs_entity_t flow_goal(
+    ecs_world_t *world)
+{
+    ecs_entity_t goal = ecs_new_id(world);
+    ecs_set(world, goal, EcsPosition3, {128, 0, 128});
+    ecs_set(world, goal, EcsFlowField, { .radius = 1 });
+    return goal;
+}
+
+/* Wall of three impassable tiles at x = 170, in front of the goal */
+static
+void flow_wall(
+    ecs_world_t *world,
+    ecs_entity_t *wall)
+{
+    for (int32_t i = 0; i < 3; i ++) {
+        wall[i] = ecs_new_id(world);
+        ecs_set(world, wall[i], EcsPosition3, {170, 0, 100 + i * 32});
+        ecs_set(world, wall[i], EcsNavObstacle, { .cost = 0 });
+    }
+}
+
+static
+void flow_test_dir(
+    ecs_world_t *world,
+    ecs_entity_t goal,
+    float x,
+    float z,
+    float dx_expect,
+    float dy_expect)
+{
+    float dx, dy;
+    test_bool(ecs_flow_field_direction(world, goal, x, z, &dx, &dy), true);
+    test_flt(dx, dx_expect);
+    test_flt(dy, dy_expect);
+}
+
+void FlowField_block_path(void) {
+    ecs_world_t *world = ecs_init();
+    ECS_IMPORT(world, FlecsGameCore);
+
+    ecs_entity_t goal = flow_goal(world);
+    ecs_progress(world, 0);
+    flow_test_dir(world, goal, 200, 128, -1, 0);
+
+    ecs_entity_t wall[3];
+    flow_wall(world, wall);
+    ecs_progress(world, 0);
+
+    /* The direct path is blocked, the tile next to the wall moves around it */
+    float dx, dy;
+    test_bool(ecs_flow_field_direction(world, goal, 200, 128, &dx, &dy), true);
+    test_assert(dx != -1 || dy != 0);
+
+    /* Tiles behind the wall are still reachable */
+    test_bool(ecs_flow_field_direction(world, goal, 300, 128, &dx, &dy), true);
+
+    for (int32_t i = 0; i < 3; i ++) {
+        ecs_delete(world, wall[i]);
+    }
+
+    ecs_progress(world, 0);
+    flow_test_dir(world, goal, 200, 128, -1, 0);
+
+    ecs_fini(world);
+}
+
+void FlowField_update_matches_build(void) {
+    ecs_world_t *world = ecs_init();
+    ECS_IMPORT(world, FlecsGameCore);
+
+    ecs_entity_t updated = flow_goal(world);
+    ecs_progress(world, 0);
+
+    ecs_entity_t wall[3];
+    flow_wall(world, wall);
+
+    /* Added after the obstacles, so that it is built in one go */
+    ecs_entity_t built = flow_goal(world);
+    ecs_progress(world, 0);
+
+    for (float z = -200; z < 500; z += 32) {
+        for (float x = -200; x < 500; x += 32) {
+            float dx_u, dy_u, dx_b, dy_b;
+            test_bool(
+                ecs_flow_field_direction(world, updated, x, z, &dx_u, &dy_u),
+                ecs_flow_field_direction(world, built, x, z, &dx_b, &dy_b));
+            test_flt(dx_u, dx_b);
+            test_flt(dy_u, dy_b);
+        }
+    }
+
+    ecs_fini(world);
+}
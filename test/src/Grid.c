@@ -0,0 +1,95 @@
+#include <flecs_game_test.h>
+
+static
+ecs_entity_t grid_async(
+    ecs_world_t *world,
+    int32_t tiles_per_frame,
+    float time_budget)
+{
+    ecs_entity_t tile = ecs_entity(world, { .name = "Tile", .add = { EcsPrefab } });
+    ecs_entity_t grid = ecs_new_id(world);
+    ecs_set(world, grid, EcsGridAsync, {
+        .tiles_per_frame = tiles_per_frame,
+        .time_budget = time_budget
+    });
+    ecs_set(world, grid, EcsGrid, {
+        .x = { .count = 5, .spacing = 10 },
+        .z = { .count = 5, .spacing = 10 },
+        .prefab = tile
+    });
+    return grid;
+}
+
+/* Test that all tiles of grid are assigned to a world cell */
+static
+void grid_test_cells(
+    ecs_world_t *world,
+    ecs_entity_t grid)
+{
+    ecs_iter_t it = ecs_term_iter(world, &(ecs_term_t){
+        .id = ecs_pair(EcsChildOf, grid)
+    });
+
+    while (ecs_term_next(&it)) {
+        for (int i = 0; i < it.count; i ++) {
+            test_assert(ecs_has_pair(world, it.entities[i],
+                EcsWorldCell, EcsWildcard));
+        }
+    }
+}
+
+void Grid_async_tiles_per_frame(void) {
+    ecs_world_t *world = ecs_init();
+    ECS_IMPORT(world, FlecsGameCore);
+
+    ecs_entity_t grid = grid_async(world, 10, 0);
+    test_int(ecs_count_id(world, ecs_pair(EcsChildOf, grid)), 0);
+    test_assert(!ecs_has(world, grid, EcsGridReady));
+
+    ecs_progress(world, 0);
+    test_int(ecs_count_id(world, ecs_pair(EcsChildOf, grid)), 10);
+    test_assert(!ecs_has(world, grid, EcsGridReady));
+
+    /* Tiles are assigned to cells in the frame they are created */
+    grid_test_cells(world, grid);
+
+    ecs_progress(world, 0);
+    test_int(ecs_count_id(world, ecs_pair(EcsChildOf, grid)), 20);
+    test_assert(!ecs_has(world, grid, EcsGridReady));
+
+    ecs_progress(world, 0);
+    test_int(ecs_count_id(world, ecs_pair(EcsChildOf, grid)), 25);
+    test_assert(ecs_has(world, grid, EcsGridReady));
+    grid_test_cells(world, grid);
+
+    const EcsGameStats *stats = ecs_singleton_get(world, EcsGameStats);
+    test_assert(stats != NULL);
+    test_int(stats->grid_tiles, 25);
+
+    ecs_fini(world);
+}
+
+void Grid_async_time_budget(void) {
+    ecs_world_t *world = ecs_init();
+    ECS_IMPORT(world, FlecsGameCore);
+
+    /* Creating a tile takes longer than the budget, so each frame creates the
+     * one tile that is created before the budget is checked. */
+    ecs_entity_t grid = grid_async(world, 0, 0.000000001f);
+
+    for (int32_t i = 1; i < 25; i ++) {
+        ecs_progress(world, 0);
+        test_int(ecs_count_id(world, ecs_pair(EcsChildOf, grid)), i);
+        test_assert(!ecs_has(world, grid, EcsGridReady));
+    }
+
+    ecs_progress(world, 0);
+    test_int(ecs_count_id(world, ecs_pair(EcsChildOf, grid)), 25);
+    test_assert(ecs_has(world, grid, EcsGridReady));
+
+    const EcsGameStats *stats = ecs_singleton_get(world, EcsGameStats);
+    test_assert(stats != NULL);
+    test_assert(stats->grid_time > 0);
+
+    ecs_fini(world);
+}
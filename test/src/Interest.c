@@ -0,0 +1,192 @@
+#include <flecs_game_test.h>
+
+static
+ecs_world_t* interest_world(void) {
+    ecs_world_t *world = ecs_init();
+    ECS_IMPORT(world, FlecsGameCore);
+    return world;
+}
+
+/* Observer with an area that covers only world cell (0, 0) */
+static
+ecs_entity_t interest_observer(
+    ecs_world_t *world)
+{
+    ecs_entity_t observer = ecs_new_id(world);
+    ecs_set(world, observer, EcsPosition3, {128, 0, 128});
+    ecs_set(world, observer, EcsInterestArea, { .radius = 10 });
+    return observer;
+}
+
+static
+ecs_entity_t interest_entity(
+    ecs_world_t *world,
+    float x,
+    float z)
+{
+    ecs_entity_t e = ecs_new_id(world);
+    ecs_set(world, e, EcsPosition3, {x, 0, z});
+    return e;
+}
+
+static
+bool interest_has(
+    const ecs_entity_t *entities,
+    int32_t count,
+    ecs_entity_t e)
+{
+    for (int32_t i = 0; i < count; i ++) {
+        if (entities[i] == e) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Interest_enter_leave(void) {
+    ecs_world_t *world = interest_world();
+    ecs_entity_t observer = interest_observer(world);
+    ecs_entity_t e1 = interest_entity(world, 100, 100);
+    ecs_entity_t e2 = interest_entity(world, 1000, 1000);
+    int32_t count;
+    const ecs_entity_t *entities;
+
+    ecs_progress(world, 0);
+    entities = ecs_interest_enter(world, observer, &count);
+    test_int(count, 2);
+    test_assert(interest_has(entities, count, observer));
+    test_assert(interest_has(entities, count, e1));
+    ecs_interest_leave(world, observer, &count);
+    test_int(count, 0);
+
+    /* Nothing changed */
+    ecs_progress(world, 0);
+    ecs_interest_enter(world, observer, &count);
+    test_int(count, 0);
+    ecs_interest_leave(world, observer, &count);
+    test_int(count, 0);
+
+    /* e1 moves out of the area, e2 moves in */
+    ecs_set(world, e1, EcsPosition3, {1000, 0, 100});
+    ecs_set(world, e2, EcsPosition3, {50, 0, 50});
+    ecs_progress(world, 0);
+
+    entities = ecs_interest_enter(world, observer, &count);
+    test_int(count, 1);
+    test_assert(entities[0] == e2);
+    entities = ecs_interest_leave(world, observer, &count);
+    test_int(count, 1);
+    test_assert(entities[0] == e1);
+
+    ecs_fini(world);
+}
+
+void Interest_update(void) {
+    ecs_world_t *world = interest_world();
+    ecs_entity_t observer = interest_observer(world);
+    ecs_entity_t e = interest_entity(world, 100, 100);
+    int32_t count;
+    const ecs_entity_t *entities;
+
+    ecs_progress(world, 0);
+    ecs_progress(world, 0);
+    ecs_interest_update(world, observer, &count);
+    test_int(count, 0);
+
+    /* Move within the same cell */
+    ecs_set(world, e, EcsPosition3, {110, 0, 100});
+    ecs_progress(world, 0);
+
+    ecs_interest_enter(world, observer, &count);
+    test_int(count, 0);
+    ecs_interest_leave(world, observer, &count);
+    test_int(count, 0);
+    entities = ecs_interest_update(world, observer, &count);
+    test_assert(interest_has(entities, count, e));
+
+    ecs_fini(world);
+}
+
+void Interest_leave_on_delete(void) {
+    ecs_world_t *world = interest_world();
+    ecs_entity_t observer = interest_observer(world);
+    ecs_entity_t e = interest_entity(world, 100, 100);
+    int32_t count;
+    const ecs_entity_t *entities;
+
+    ecs_progress(world, 0);
+    entities = ecs_interest_enter(world, observer, &count);
+    test_assert(interest_has(entities, count, e));
+
+    ecs_delete(world, e);
+    ecs_progress(world, 0);
+
+    ecs_interest_enter(world, observer, &count);
+    test_int(count, 0);
+    entities = ecs_interest_leave(world, observer, &count);
+    test_int(count, 1);
+    test_assert(entities[0] == e);
+
+    ecs_fini(world);
+}
+
+void Interest_move_area(void) {
+    ecs_world_t *world = interest_world();
+    ecs_entity_t observer = interest_observer(world);
+    ecs_entity_t e1 = interest_entity(world, 100, 100);
+    ecs_entity_t e2 = interest_entity(world, 1000, 100);
+    int32_t count;
+    const ecs_entity_t *entities;
+
+    ecs_progress(world, 0);
+    entities = ecs_interest_enter(world, observer, &count);
+    test_assert(interest_has(entities, count, e1));
+    test_assert(!interest_has(entities, count, e2));
+
+    /* Area now only covers cell (3, 0) */
+    ecs_set(world, observer, EcsPosition3, {1000, 0, 128});
+    ecs_progress(world, 0);
+
+    entities = ecs_interest_enter(world, observer, &count);
+    test_int(count, 1);
+    test_assert(entities[0] == e2);
+    entities = ecs_interest_leave(world, observer, &count);
+    test_int(count, 1);
+    test_assert(entities[0] == e1);
+
+    /* The observer moved along with its area */
+    entities = ecs_interest_update(world, observer, &count);
+    test_assert(interest_has(entities, count, observer));
+
+    ecs_fini(world);
+}
+
+void Interest_move_to_covered_cell(void) {
+    ecs_world_t *world = interest_world();
+    ecs_entity_t e = interest_entity(world, 250, 100);
+    int32_t count;
+    const ecs_entity_t *entities;
+
+    /* Area covers cells (0, 0) and (1, 0) */
+    ecs_entity_t observer = ecs_new_id(world);
+    ecs_set(world, observer, EcsPosition3, {256, 0, 128});
+    ecs_set(world, observer, EcsInterestArea, { .radius = 10 });
+
+    ecs_progress(world, 0);
+    entities = ecs_interest_enter(world, observer, &count);
+    test_assert(interest_has(entities, count, e));
+
+    /* Moves to the other covered cell, so it doesn't leave */
+    ecs_set(world, e, EcsPosition3, {260, 0, 100});
+    ecs_progress(world, 0);
+    test_int(ecs_world_cell_index(260), 1);
+
+    ecs_interest_enter(world, observer, &count);
+    test_int(count, 0);
+    ecs_interest_leave(world, observer, &count);
+    test_int(count, 0);
+    entities = ecs_interest_update(world, observer, &count);
+    test_assert(interest_has(entities, count, e));
+
+    ecs_fini(world);
+}
@@ -0,0 +1,47 @@
+#include <flecs_game_test.h>
+
+static
+void lod_camera_move(
+    ecs_world_t *world,
+    ecs_entity_t camera,
+    float x)
+{
+    ecs_set(world, camera, EcsCamera, {
+        .position = {x, 0, 128}, .lookat = {x, 0, 0}, .up = {0, 1, 0}
+    });
+}
+
+void Lod_switch_variant(void) {
+    ecs_world_t *world = ecs_init();
+    ECS_IMPORT(world, FlecsGame);
+
+    ecs_entity_t tree = ecs_entity(world, { .name = "Tree", .add = { EcsPrefab } });
+    ecs_entity_t tree_far = ecs_entity(world, {
+        .name = "TreeFar", .add = { EcsPrefab } });
+    ecs_set(world, tree, EcsLod, {
+        .levels = {{ .prefab = tree_far, .distance = 500 }}
+    });
+
+    ecs_entity_t inst = ecs_new_w_pair(world, EcsIsA, tree);
+    ecs_set(world, inst, EcsPosition3, {128, 0, 128});
+
+    ecs_entity_t camera = ecs_new_id(world);
+    lod_camera_move(world, camera, 128);
+
+    ecs_progress(world, 0);
+    test_assert(ecs_has_pair(world, inst, EcsIsA, tree));
+    test_assert(!ecs_has_pair(world, inst, EcsIsA, tree_far));
+
+    /* Cell (0, 0) is now more than 500 units away from the camera */
+    lod_camera_move(world, camera, 1000);
+    ecs_progress(world, 0);
+    test_assert(!ecs_has_pair(world, inst, EcsIsA, tree));
+    test_assert(ecs_has_pair(world, inst, EcsIsA, tree_far));
+
+    lod_camera_move(world, camera, 300);
+    ecs_progress(world, 0);
+    test_assert(ecs_has_pair(world, inst, EcsIsA, tree));
+    test_assert(!ecs_has_pair(world, inst, EcsIsA, tree_far));
+
+    ecs_fini(world);
+}
@@ -0,0 +1,118 @@
+#include <flecs_game_test.h>
+
+#define RAYCAST_RADIUS (0.1f)
+
+/* Members are spheres with RAYCAST_RADIUS around their position. The hit
+ * distance is where the ray enters the sphere. */
+static
+int32_t raycast_sphere(
+    ecs_iter_t *it,
+    const ecs_world_cell_ray_t *ray,
+    float *distance)
+{
+    int32_t result = -1;
+    const EcsPosition3 *o = &ray->origin, *d = &ray->direction;
+    float r2 = RAYCAST_RADIUS * RAYCAST_RADIUS;
+
+    for (int i = 0; i < it->count; i ++) {
+        const EcsPosition3 *p = ecs_get(it->world, it->entities[i], EcsPosition3);
+        if (!p) {
+            continue;
+        }
+
+        /* Distance along the ray to the point closest to the center */
+        float t = (p->x - o->x) * d->x + (p->y - o->y) * d->y +
+            (p->z - o->z) * d->z;
+
+        float cx = o->x + d->x * t - p->x;
+        float cy = o->y + d->y * t - p->y;
+        float cz = o->z + d->z * t - p->z;
+        float c2 = cx * cx + cy * cy + cz * cz;
+        if (c2 > r2) {
+            continue;
+        }
+
+        float entry = t - sqrtf(r2 - c2);
+        if (entry < 0 || entry >= *distance) {
+            continue;
+        }
+
+        *distance = entry;
+        result = i;
+    }
+
+    return result;
+}
+
+static
+ecs_entity_t raycast_member(
+    ecs_world_t *world,
+    float x,
+    float z)
+{
+    ecs_entity_t e = ecs_new_id(world);
+    ecs_set(world, e, EcsPosition3, {x, 0, z});
+    return e;
+}
+
+void Raycast_cross_negative_bound(void) {
+    ecs_world_t *world = ecs_init();
+    ECS_IMPORT(world, FlecsGameCore);
+
+    /* Cell -1 spans (-256, -1], the member is in cell -2 */
+    ecs_entity_t e = raycast_member(world, -300, 10);
+    ecs_progress(world, 0);
+    test_int(ecs_world_cell_index(-300), -2);
+
+    ecs_world_cell_ray_hit_t hit;
+    test_bool(ecs_world_cell_raycast(world, &(ecs_world_cell_ray_t){
+        .origin = {-200, 0, 10},
+        .direction = {-1, 0, 0},
+        .max_distance = 200,
+        .test = raycast_sphere
+    }, &hit), true);
+    test_assert(hit.entity == e);
+    test_flt(hit.distance, 100 - RAYCAST_RADIUS);
+
+    ecs_fini(world);
+}
+
+void Raycast_cross_negative_bound_diagonal(void) {
+    ecs_world_t *world = ecs_init();
+    ECS_IMPORT(world, FlecsGameCore);
+
+    /* The ray crosses z = 256 at x = -256.5, and x = -256 at z = 256.5. The
+     * member is in cell (-2, 1), which the ray only crosses for a unit. */
+    ecs_entity_t e = raycast_member(world, -256.2, 256.3);
+    ecs_progress(world, 0);
+    test_int(ecs_world_cell_index(-256.2), -2);
+    test_int(ecs_world_cell_index(256.3), 1);
+
+    float d = 1.0f / sqrtf(2.0f);
+    ecs_world_cell_ray_hit_t hit;
+    test_bool(ecs_world_cell_raycast(world, &(ecs_world_cell_ray_t){
+        .origin = {-300, 0, 212.5},
+        .direction = {d, 0, d},
+        .max_distance = 200,
+        .test = raycast_sphere
+    }, &hit), true);
+    test_assert(hit.entity == e);
+
+    ecs_fini(world);
+}
+
+void Raycast_cell_lower(void) {
+    float size = FLECS_GAME_WORLD_CELL_SIZE;
+
+    test_flt(ecs_world_cell_lower(0), -1);
+    test_flt(ecs_world_cell_lower(1), size);
+    test_flt(ecs_world_cell_lower(-1), -size);
+    test_flt(ecs_world_cell_lower(-2), -2 * size);
+
+    /* Lower bounds are exclusive for negative cells */
+    test_int(ecs_world_cell_index(-0.5), 0);
+    test_int(ecs_world_cell_index(-1), -1);
+    test_int(ecs_world_cell_index(-255.5), -1);
+    test_int(ecs_world_cell_index(-256), -2);
+    test_int(ecs_world_cell_index(size), 1);
+}
@@ -0,0 +1,118 @@
+#include <flecs_game_test.h>
+#include <stdio.h>
+
+#define SNAPSHOT_FILE "snapshot_test.bin"
+
+static
+ecs_world_t* snapshot_world(void) {
+    ecs_world_t *world = ecs_init();
+    ECS_IMPORT(world, FlecsGameCore);
+    ecs_entity(world, { .name = "Tile", .add = { EcsPrefab } });
+    return world;
+}
+
+/* 4 x 4 tiles at -300, -100, 100, 300, so that each tile is in its own cell */
+static
+ecs_entity_t snapshot_grid(
+    ecs_world_t *world)
+{
+    ecs_entity_t grid = ecs_entity(world, { .name = "Forest" });
+    ecs_set(world, grid, EcsGrid, {
+        .x = { .count = 4, .spacing = 200 },
+        .z = { .count = 4, .spacing = 200 },
+        .prefab = ecs_lookup(world, "Tile")
+    });
+    return grid;
+}
+
+static
+bool snapshot_is_grid_coord(
+    float v)
+{
+    return v == -300 || v == -100 || v == 100 || v == 300;
+}
+
+/* Test that grid has all its tiles, each in the cell that contains it */
+static
+void snapshot_test_tiles(
+    ecs_world_t *world,
+    ecs_entity_t grid)
+{
+    int32_t count = 0;
+    ecs_iter_t it = ecs_term_iter(world, &(ecs_term_t){
+        .id = ecs_pair(EcsChildOf, grid)
+    });
+
+    while (ecs_term_next(&it)) {
+        for (int i = 0; i < it.count; i ++) {
+            ecs_entity_t e = it.entities[i];
+            const EcsPosition3 *p = ecs_get(world, e, EcsPosition3);
+            test_assert(p != NULL);
+            test_assert(snapshot_is_grid_coord(p->x));
+            test_assert(snapshot_is_grid_coord(p->z));
+
+            ecs_entity_t cell = ecs_world_cell_find(world, p->x, p->z);
+            test_assert(cell != 0);
+            test_assert(ecs_has_pair(world, e, EcsWorldCell, cell));
+            count ++;
+        }
+    }
+
+    test_int(count, 16);
+}
+
+void Snapshot_round_trip(void) {
+    ecs_world_t *world = snapshot_world();
+    ecs_entity_t grid = snapshot_grid(world);
+    ecs_progress(world, 0);
+    snapshot_test_tiles(world, grid);
+
+    test_int(ecs_game_snapshot_save(world, SNAPSHOT_FILE), 0);
+    ecs_fini(world);
+
+    world = snapshot_world();
+    test_int(ecs_game_snapshot_restore(world, SNAPSHOT_FILE), 0);
+
+    grid = ecs_lookup(world, "Forest");
+    test_assert(grid != 0);
+    test_assert(ecs_has(world, grid, EcsGridReady));
+    const EcsGrid *g = ecs_get(world, grid, EcsGrid);
+    test_assert(g != NULL);
+    test_int(g->x.count, 4);
+    test_int(g->z.count, 4);
+
+    /* Tiles are restored in their cell, so the first frame moves nothing */
+    snapshot_test_tiles(world, grid);
+    ecs_progress(world, 0);
+
+    const EcsGameStats *stats = ecs_singleton_get(world, EcsGameStats);
+    test_assert(stats != NULL);
+    test_int(stats->cells_created, 0);
+    test_int(stats->cell_migrations, 0);
+    snapshot_test_tiles(world, grid);
+
+    ecs_fini(world);
+    remove(SNAPSHOT_FILE);
+}
+
+void Snapshot_round_trip_unassigned(void) {
+    ecs_world_t *world = snapshot_world();
+    snapshot_grid(world);
+
+    /* Save before the tiles are assigned to cells */
+    test_int(ecs_game_snapshot_save(world, SNAPSHOT_FILE), 0);
+    ecs_fini(world);
+
+    world = snapshot_world();
+    test_int(ecs_game_snapshot_restore(world, SNAPSHOT_FILE), 0);
+
+    ecs_entity_t grid = ecs_lookup(world, "Forest");
+    test_assert(grid != 0);
+    test_int(ecs_count_id(world, ecs_pair(EcsChildOf, grid)), 16);
+
+    ecs_progress(world, 0);
+    snapshot_test_tiles(world, grid);
+
+    ecs_fini(world);
+    remove(SNAPSHOT_FILE);
+}
@@ -0,0 +1,91 @@
+#include <flecs_game_test.h>
+
+/* Curve that goes from black at midnight to white at noon */
+static
+void time_of_day_curve(
+    ecs_world_t *world)
+{
+    ecs_singleton_set(world, EcsTimeOfDayCurve, {
+        .count = 2,
+        .keys = {{
+            .sun_height = -1,
+            .sun_color = {0, 0, 0},
+            .sun_intensity = 0,
+            .ambient_color = {0, 0, 0}
+        }, {
+            .sun_height = 1,
+            .sun_color = {1, 1, 1},
+            .sun_intensity = 1,
+            .ambient_color = {0.5, 0.5, 0.5}
+        }}
+    });
+}
+
+static
+ecs_time_of_day_sample_t time_of_day_sample(
+    ecs_world_t *world,
+    float t)
+{
+    const EcsTimeOfDayTable *table = ecs_singleton_get(
+        world, EcsTimeOfDayTable);
+    test_assert(table != NULL);
+
+    ecs_time_of_day_sample_t result;
+    ecs_time_of_day_sample(table, t, &result);
+    return result;
+}
+
+void TimeOfDay_sample_curve(void) {
+    ecs_world_t *world = ecs_init();
+    ECS_IMPORT(world, FlecsGameCore);
+    time_of_day_curve(world);
+
+    /* Noon */
+    ecs_time_of_day_sample_t s = time_of_day_sample(world, 0.5);
+    test_flt(s.sun_intensity, 1);
+    test_flt(s.sun_color[0], 1);
+    test_flt(s.ambient_color[2], 0.5);
+
+    /* Midnight */
+    s = time_of_day_sample(world, 1.5);
+    test_flt(s.sun_intensity, 0);
+    test_flt(s.sun_color[1], 0);
+    test_flt(s.ambient_color[0], 0);
+
+    /* Sunrise, halfway between the keys */
+    s = time_of_day_sample(world, 0);
+    test_flt(s.sun_intensity, 0.5);
+    test_flt(s.sun_color[2], 0.5);
+    test_flt(s.ambient_color[1], 0.25);
+
+    /* The day cycle repeats every 2 units */
+    s = time_of_day_sample(world, 2.5);
+    test_flt(s.sun_intensity, 1);
+
+    ecs_fini(world);
+}
+
+void TimeOfDay_remove_curve(void) {
+    ecs_world_t *world = ecs_init();
+    ECS_IMPORT(world, FlecsGameCore);
+    time_of_day_curve(world);
+
+    ecs_time_of_day_sample_t s = time_of_day_sample(world, 0.5);
+    test_flt(s.sun_intensity, 1);
+
+    /* Removing the curve restores the built-in day cycle */
+    ecs_singleton_remove(world, EcsTimeOfDayCurve);
+    s = time_of_day_sample(world, 0.5);
+    test_flt(s.sun_intensity, 1.07);
+
+    ecs_fini(world);
+}
+
+void TimeOfDay_fini_with_curve(void) {
+    ecs_world_t *world = ecs_init();
+    ECS_IMPORT(world, FlecsGameCore);
+    time_of_day_curve(world);
+
+    /* Removing the curve during cleanup must not add the table back */
+    ecs_fini(world);
+}
@@ -0,0 +1,90 @@
+#include <flecs_game_test.h>
+
+/* Copy of the entity and its position, to check that sorting moves component
+ * values along with their entities. */
+typedef struct {
+    ecs_entity_t entity;
+    float x;
+    float z;
+} SortCheck;
+
+ECS_COMPONENT_DECLARE(SortCheck);
+
+static
+void sort_test_table(
+    ecs_world_t *world,
+    int32_t expect)
+{
+    int32_t count = 0;
+    ecs_iter_t it = ecs_term_iter(world, &(ecs_term_t){
+        .id = ecs_id(SortCheck)
+    });
+
+    while (ecs_term_next(&it)) {
+        SortCheck *c = ecs_field(&it, SortCheck, 1);
+        for (int i = 0; i < it.count; i ++) {
+            test_assert(c[i].entity == it.entities[i]);
+
+            const EcsPosition3 *p = ecs_get(world, it.entities[i], EcsPosition3);
+            test_assert(p != NULL);
+            test_flt(p->x, c[i].x);
+            test_flt(p->z, c[i].z);
+
+            /* Positions are on a diagonal, which is sorted by coordinate */
+            if (i) {
+                test_assert(c[i].x > c[i - 1].x);
+            }
+        }
+        count += it.count;
+    }
+
+    test_int(count, expect);
+}
+
+static
+ecs_entity_t sort_entity(
+    ecs_world_t *world,
+    float v)
+{
+    ecs_entity_t e = ecs_new_id(world);
+    ecs_set(world, e, EcsPosition3, {v, 0, v});
+    ecs_set(world, e, SortCheck, { e, v, v });
+    return e;
+}
+
+void WorldCellSort_keep_values_paired(void) {
+    ecs_world_t *world = ecs_init();
+    ECS_IMPORT(world, FlecsGameCore);
+    ECS_COMPONENT_DEFINE(world, SortCheck);
+    ecs_singleton_set(world, EcsWorldCellSort, { .migration_threshold = 0 });
+
+    /* Created in reverse Z-order, so that sorting swaps rows */
+    for (int32_t i = 0; i < 64; i ++) {
+        sort_entity(world, 250 - i * 3);
+    }
+
+    ecs_progress(world, 0);
+    ecs_progress(world, 0);
+    sort_test_table(world, 64);
+
+    ecs_fini(world);
+}
+
+void WorldCellSort_cell_0_strip(void) {
+    ecs_world_t *world = ecs_init();
+    ECS_IMPORT(world, FlecsGameCore);
+    ECS_COMPONENT_DEFINE(world, SortCheck);
+    ecs_singleton_set(world, EcsWorldCellSort, { .migration_threshold = 0 });
+
+    /* Cell 0 spans (-1, 256), so -0.5 is at the start of the cell */
+    sort_entity(world, 10);
+    sort_entity(world, 5);
+    sort_entity(world, -0.5);
+    test_int(ecs_world_cell_index(-0.5), 0);
+
+    ecs_progress(world, 0);
+    ecs_progress(world, 0);
+    sort_test_table(world, 3);
+
+    ecs_fini(world);
+}